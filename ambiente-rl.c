@@ -0,0 +1,172 @@
+// Ambiente de aprendizado por reforço (ambiente-rl.h), compilado em libtetris-ambiente.so junto com motor.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "motor.h"
+#include "ambiente-rl.h"
+
+// --- Ambiente de Aprendizado por Reforço (API C com passos em lote) ---
+
+_Static_assert(AMBIENTE_TAMANHO_FILA == CAPACIDADE_FILA && AMBIENTE_TAMANHO_PILHA == CAPACIDADE_PILHA &&
+                   AMBIENTE_NUM_TIPOS == NUM_TIPOS_PECA,
+               "ambiente-rl.h precisa das mesmas capacidades do motor");
+
+// Letra -> índice em TIPOS_PECA numa única consulta (indiceTipoPeca percorre os tipos)
+static const uint8_t TIPO_POR_LETRA[256] = {['I'] = 0, ['O'] = 1, ['T'] = 2, ['L'] = 3, ['J'] = 4, ['S'] = 5, ['Z'] = 6};
+
+/**
+ * @struct PartidaAmbiente
+ */
+typedef struct
+{
+    Jogo jogo;
+    uint32_t passos; // Ações já feitas no episódio atual
+} PartidaAmbiente;
+
+struct AmbienteTetris
+{
+    int total;
+    uint32_t passos_por_episodio;
+    uint64_t semente;
+    uint64_t proximo_jogo; // Número de jogo do próximo episódio a começar
+    BuffersAmbiente buffers;
+    PartidaAmbiente *partidas;
+};
+
+// Escreve a observação da partida i: tipos da fila e da pilha e a máscara de ações válidas
+static inline void escreverObservacao(const BuffersAmbiente *buffers, int i, const Jogo *jogo)
+{
+    const FilaCircular *fila = &jogo->fila;
+    const Pilha *pilha = &jogo->pilha;
+    uint8_t *tipos_fila = buffers->fila + (size_t)i * AMBIENTE_TAMANHO_FILA;
+    uint8_t *tipos_pilha = buffers->pilha + (size_t)i * AMBIENTE_TAMANHO_PILHA;
+    uint8_t *mascara = buffers->mascara + (size_t)i * AMBIENTE_NUM_ACOES;
+
+    int indice = fila->frente;
+    for (int j = 0; j < CAPACIDADE_FILA; j++)
+    {
+        tipos_fila[j] = j < fila->tamanho ? TIPO_POR_LETRA[(unsigned char)fila->itens[indice].nome[0]] : AMBIENTE_TIPO_VAZIO;
+        indice = indice + 1 == CAPACIDADE_FILA ? 0 : indice + 1;
+    }
+    for (int j = 0; j < CAPACIDADE_PILHA; j++)
+    {
+        tipos_pilha[j] = j <= pilha->topo ? TIPO_POR_LETRA[(unsigned char)pilha->itens[pilha->topo - j].nome[0]]
+                                          : AMBIENTE_TIPO_VAZIO;
+    }
+
+    // As mesmas condições que o motor confere antes de cada operação
+    int tem_fila = !filaVazia(fila);
+    int tem_pilha = !pilhaVazia(pilha);
+    mascara[AMBIENTE_JOGAR] = (uint8_t)tem_fila;
+    mascara[AMBIENTE_RESERVAR] = (uint8_t)(tem_fila && !pilhaCheia(pilha));
+    mascara[AMBIENTE_USAR] = (uint8_t)tem_pilha;
+    mascara[AMBIENTE_TROCAR] = (uint8_t)(tem_fila && tem_pilha);
+    mascara[AMBIENTE_DESFAZER] = (uint8_t)(jogo->ultima_operacao != OP_NENHUMA);
+    mascara[AMBIENTE_INVERTER] = 1;
+}
+
+// Peças que já foram para o tabuleiro: geradas menos as que ainda estão na fila ou na pilha
+static inline int64_t pecasColocadas(const Jogo *jogo)
+{
+    return (int64_t)jogo->gerador.posicao - jogo->fila.tamanho - (jogo->pilha.topo + 1);
+}
+
+/**
+ * Aplica uma ação do agente e devolve a recompensa descrita em BuffersAmbiente. A variação
+ * das peças colocadas dá +1 em Jogar e Usar, -1 ao desfazer um Jogar e 0 no resto, sem um
+ * segundo desvio por ação (com uma política aleatória, cada desvio desses erra a previsão).
+ */
+static inline float aplicarAcaoAmbiente(Jogo *jogo, uint8_t acao)
+{
+    if (acao >= AMBIENTE_NUM_ACOES)
+    {
+        return -1.0f;
+    }
+
+    int64_t antes = pecasColocadas(jogo);
+    if (executarAcao(jogo, (Acao)(ACAO_JOGAR + acao)) != RESULTADO_OK)
+    {
+        return -1.0f;
+    }
+    return (float)(pecasColocadas(jogo) - antes);
+}
+
+static void comecarEpisodio(AmbienteTetris *ambiente, PartidaAmbiente *partida)
+{
+    inicializarJogo(&partida->jogo, ambiente->semente, ambiente->proximo_jogo++);
+    partida->passos = 0;
+}
+
+AmbienteTetris *ambienteCriar(int n_ambientes, uint32_t passos_por_episodio, const BuffersAmbiente *buffers)
+{
+    if (n_ambientes < 1 || passos_por_episodio < 1 || buffers == NULL || buffers->fila == NULL ||
+        buffers->pilha == NULL || buffers->mascara == NULL || buffers->recompensa == NULL || buffers->terminado == NULL)
+    {
+        return NULL;
+    }
+
+    AmbienteTetris *ambiente = malloc(sizeof(AmbienteTetris));
+    PartidaAmbiente *partidas = malloc((size_t)n_ambientes * sizeof(PartidaAmbiente));
+    if (ambiente == NULL || partidas == NULL)
+    {
+        free(ambiente);
+        free(partidas);
+        return NULL;
+    }
+
+    ambiente->total = n_ambientes;
+    ambiente->passos_por_episodio = passos_por_episodio;
+    ambiente->buffers = *buffers;
+    ambiente->partidas = partidas;
+    ambienteReiniciar(ambiente, 0);
+    return ambiente;
+}
+
+void ambienteReiniciar(AmbienteTetris *ambiente, uint64_t semente)
+{
+    ambiente->semente = semente;
+    ambiente->proximo_jogo = 0;
+    for (int i = 0; i < ambiente->total; i++)
+    {
+        comecarEpisodio(ambiente, &ambiente->partidas[i]);
+        ambiente->buffers.recompensa[i] = 0.0f;
+        ambiente->buffers.terminado[i] = 0;
+        escreverObservacao(&ambiente->buffers, i, &ambiente->partidas[i].jogo);
+    }
+}
+
+int ambienteAvancar(AmbienteTetris *ambiente, const uint8_t *acoes, int n_ambientes)
+{
+    if (n_ambientes < 0 || n_ambientes > ambiente->total)
+    {
+        return 0;
+    }
+
+    // Cópia local dos ponteiros: as escritas nos buffers (uint8_t) não obrigam a relê-los
+    BuffersAmbiente buffers = ambiente->buffers;
+    for (int i = 0; i < n_ambientes; i++)
+    {
+        PartidaAmbiente *partida = &ambiente->partidas[i];
+        buffers.recompensa[i] = aplicarAcaoAmbiente(&partida->jogo, acoes[i]);
+        buffers.terminado[i] = 0;
+        if (++partida->passos >= ambiente->passos_por_episodio)
+        {
+            comecarEpisodio(ambiente, partida);
+            buffers.terminado[i] = 1;
+        }
+        escreverObservacao(&buffers, i, &partida->jogo);
+    }
+    return 1;
+}
+
+void ambienteDestruir(AmbienteTetris *ambiente)
+{
+    if (ambiente != NULL)
+    {
+        free(ambiente->partidas);
+        free(ambiente);
+    }
+}
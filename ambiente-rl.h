@@ -0,0 +1,93 @@
+/*
+ * Ambiente de aprendizado por reforço do Tetris Stack: API C para treinar agentes na mecânica
+ * de fila e reserva sem passar pelo menu.
+ *
+ * Um AmbienteTetris guarda N partidas independentes e avança todas numa única chamada. Os
+ * buffers de observação pertencem a quem chama (por exemplo, arrays do NumPy passados por
+ * ctypes) e são registrados uma vez, na criação: cada passo escreve as observações direto
+ * neles, sem cópia intermediária e sem alocar memória. Cada array é contíguo, partida após
+ * partida, para virar um tensor [N][...] sem conversão.
+ *
+ * Compilado como biblioteca compartilhada por `make ambiente` (libtetris-ambiente.so), a
+ * partir do mesmo motor do nível Mestre. Só as funções abaixo são exportadas.
+ */
+#ifndef AMBIENTE_RL_H
+#define AMBIENTE_RL_H
+
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define AMBIENTE_API __attribute__((visibility("default")))
+#else
+#define AMBIENTE_API
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define AMBIENTE_TAMANHO_FILA 5
+#define AMBIENTE_TAMANHO_PILHA 3
+#define AMBIENTE_NUM_TIPOS 7   // Tipos 0..6 = I, O, T, L, J, S, Z
+#define AMBIENTE_TIPO_VAZIO 7  // Posição sem peça (cabe num one-hot de AMBIENTE_NUM_TIPOS + 1)
+#define AMBIENTE_NUM_ACOES 6
+
+// Ações do agente: a ação a corresponde à opção a + 1 do menu
+enum
+{
+    AMBIENTE_JOGAR,
+    AMBIENTE_RESERVAR,
+    AMBIENTE_USAR,
+    AMBIENTE_TROCAR,
+    AMBIENTE_DESFAZER,
+    AMBIENTE_INVERTER
+};
+
+/**
+ * @struct BuffersAmbiente
+ * Arrays do chamador, cada um com espaço para todas as partidas do ambiente.
+ *
+ * Recompensa de cada passo: +1 por peça que vai para o tabuleiro (Jogar ou Usar), -1 ao
+ * desfazer um Jogar (a peça volta para a fila) e 0 nas demais ações. Uma ação inválida vale
+ * -1 e o motor responde como no menu: a jogada não acontece.
+ */
+typedef struct
+{
+    uint8_t *fila;      // [N][AMBIENTE_TAMANHO_FILA] tipos, da frente para a traseira
+    uint8_t *pilha;     // [N][AMBIENTE_TAMANHO_PILHA] tipos, do topo para a base
+    uint8_t *mascara;   // [N][AMBIENTE_NUM_ACOES] 1 = ação válida no estado observado
+    float *recompensa;  // [N]
+    uint8_t *terminado; // [N] 1 = o episódio acabou neste passo; a observação já é da partida seguinte
+} BuffersAmbiente;
+
+typedef struct AmbienteTetris AmbienteTetris;
+
+/**
+ * Cria n_ambientes partidas com episódios de passos_por_episodio ações. Os ponteiros de
+ * buffers são guardados (não copiados) e precisam continuar válidos até ambienteDestruir.
+ * O ambiente começa como depois de ambienteReiniciar(ambiente, 0). Retorna NULL se algum
+ * argumento for inválido ou faltar memória.
+ */
+AMBIENTE_API AmbienteTetris *ambienteCriar(int n_ambientes, uint32_t passos_por_episodio, const BuffersAmbiente *buffers);
+
+/**
+ * Reinicia todas as partidas: a partida i passa a ser o jogo i da semente, e os episódios
+ * seguintes recebem os próximos números de jogo. Escreve a primeira observação de cada uma.
+ */
+AMBIENTE_API void ambienteReiniciar(AmbienteTetris *ambiente, uint64_t semente);
+
+/**
+ * Aplica acoes[i] à partida i, para i < n_ambientes, e escreve as novas observações.
+ * Um episódio que chega ao fim é reiniciado na hora com o próximo número de jogo.
+ * Retorna 1, ou 0 (sem avançar nada) se n_ambientes estiver fora de 0..N.
+ */
+AMBIENTE_API int ambienteAvancar(AmbienteTetris *ambiente, const uint8_t *acoes, int n_ambientes);
+
+AMBIENTE_API void ambienteDestruir(AmbienteTetris *ambiente);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,233 @@
+// Geração e leitura de arquivos de sequência de peças (desafio-mestre --gerar-sequencia / --ler-sequencia)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "motor.h"
+#include "ferramentas.h"
+
+// --- Arquivos de Sequência Mapeados (geração e leitura) ---
+
+#ifdef __linux__
+#define PALAVRAS_POR_BLOCO_SEQUENCIA 65536
+
+/**
+ * Grava `total` peças do jogo (semente, jogo) com 3 ou 8 bits por peça. O arquivo é escrito
+ * com outro nome e depois renomeado: quem já tem a versão anterior mapeada continua lendo
+ * as páginas antigas, em vez de ver o arquivo encolher embaixo dele.
+ */
+int executarGeracaoSequencia(const char *caminho, uint64_t semente, uint64_t jogo, uint64_t total, int bits)
+{
+    if (bits != 3 && bits != 8)
+    {
+        printf("❌ --bits deve ser 3 ou 8.\n");
+        return 1;
+    }
+
+    char temporario[4096];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    FILE *arquivo = fopen(temporario, "wb");
+    uint64_t *bloco = malloc(PALAVRAS_POR_BLOCO_SEQUENCIA * sizeof(uint64_t));
+    if (arquivo == NULL || bloco == NULL)
+    {
+        perror(temporario);
+        free(bloco);
+        if (arquivo != NULL)
+        {
+            fclose(arquivo);
+        }
+        return 1;
+    }
+
+    CabecalhoSequencia cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    cabecalho.magico = SEQUENCIA_MAGICO;
+    cabecalho.versao = SEQUENCIA_VERSAO;
+    cabecalho.bits_por_peca = (uint32_t)bits;
+    cabecalho.total_pecas = total;
+    cabecalho.semente = semente;
+    cabecalho.jogo = jogo;
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1;
+
+    uint64_t chave = chaveDoJogo(semente, jogo);
+    uint64_t pecas_por_bloco = bits == 3 ? (uint64_t)PALAVRAS_POR_BLOCO_SEQUENCIA * SEQUENCIA_PECAS_POR_PALAVRA
+                                         : (uint64_t)PALAVRAS_POR_BLOCO_SEQUENCIA * sizeof(uint64_t);
+    double inicio = tempoAgora();
+    for (uint64_t primeira = 0; ok && primeira < total; primeira += pecas_por_bloco)
+    {
+        uint64_t n = total - primeira < pecas_por_bloco ? total - primeira : pecas_por_bloco;
+        size_t bytes;
+        if (bits == 3)
+        {
+            uint64_t palavras = (n + SEQUENCIA_PECAS_POR_PALAVRA - 1) / SEQUENCIA_PECAS_POR_PALAVRA;
+            for (uint64_t w = 0; w < palavras; w++)
+            {
+                uint64_t palavra = 0;
+                uint64_t base = primeira + w * SEQUENCIA_PECAS_POR_PALAVRA;
+                for (int j = 0; j < SEQUENCIA_PECAS_POR_PALAVRA && base + (uint64_t)j < total; j++)
+                {
+                    palavra |= (uint64_t)tipoPorChave(chave, base + (uint64_t)j) << (3 * j);
+                }
+                bloco[w] = palavra;
+            }
+            bytes = palavras * sizeof(uint64_t);
+        }
+        else
+        {
+            uint8_t *tipos = (uint8_t *)bloco;
+            for (uint64_t i = 0; i < n; i++)
+            {
+                tipos[i] = (uint8_t)tipoPorChave(chave, primeira + i);
+            }
+            bytes = n;
+        }
+        ok = fwrite(bloco, 1, bytes, arquivo) == bytes;
+    }
+    ok = fclose(arquivo) == 0 && ok;
+    free(bloco);
+
+    if (!ok || rename(temporario, caminho) != 0)
+    {
+        perror(caminho);
+        unlink(temporario);
+        return 1;
+    }
+    double duracao = tempoAgora() - inicio;
+
+    uint64_t bytes_dados = bits == 3 ? (total + SEQUENCIA_PECAS_POR_PALAVRA - 1) / SEQUENCIA_PECAS_POR_PALAVRA * 8 : total;
+    printf("💾 Sequência gravada em %s\n", caminho);
+    printf("Semente: %llu | Jogo: %llu | Peças: %llu | %d bits por peça | %.1f MB\n", (unsigned long long)semente,
+           (unsigned long long)jogo, (unsigned long long)total, bits,
+           (sizeof(CabecalhoSequencia) + bytes_dados) / 1e6);
+    printf("Tempo: %.3f s | %.1f milhões de peças/s\n", duracao, total / duracao / 1e6);
+    return 0;
+}
+
+// Fração das páginas do mapa que já estão na cache do kernel (lidas por este ou outro processo)
+static double fracaoResidente(const SequenciaArquivo *sequencia)
+{
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    size_t paginas = (sequencia->tamanho_mapa + pagina - 1) / pagina;
+    unsigned char *residentes = malloc(paginas);
+    if (residentes == NULL || mincore((void *)sequencia->mapa, sequencia->tamanho_mapa, residentes) != 0)
+    {
+        free(residentes);
+        return -1.0;
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < paginas; i++)
+    {
+        total += residentes[i] & 1;
+    }
+    free(residentes);
+    return (double)total / paginas;
+}
+
+/**
+ * Percorre a sequência inteira do arquivo pelo gerador da partida (gerarPecasLote, como
+ * a fila faz) e confere cada peça contra o gerador puro da semente do cabeçalho.
+ */
+int executarLeituraSequencia(const char *caminho)
+{
+    SequenciaArquivo sequencia;
+    if (!abrirSequenciaArquivo(&sequencia, caminho))
+    {
+        return 1;
+    }
+
+    const CabecalhoSequencia *cabecalho = (const CabecalhoSequencia *)sequencia.mapa;
+    double residente_antes = fracaoResidente(&sequencia);
+
+    // Passo medido: só a leitura pelo gerador da partida e a contagem dos tipos
+    int indice_por_letra[256] = {0};
+    for (int t = 0; t < NUM_TIPOS_PECA; t++)
+    {
+        indice_por_letra[(unsigned char)TIPOS_PECA[t]] = t;
+    }
+    uint64_t contagem[NUM_TIPOS_PECA] = {0};
+    Peca bloco[BLOCO_ANALISE];
+    GeradorPecas gerador;
+    inicializarGeradorComArquivo(&gerador, &sequencia);
+
+    double inicio = tempoAgora();
+    while (gerador.posicao < sequencia.total_pecas)
+    {
+        uint64_t restantes = sequencia.total_pecas - gerador.posicao;
+        int n = restantes < BLOCO_ANALISE ? (int)restantes : BLOCO_ANALISE;
+        gerarPecasLote(&gerador, bloco, n);
+        for (int i = 0; i < n; i++)
+        {
+            contagem[indice_por_letra[(unsigned char)bloco[i].nome[0]]]++;
+        }
+    }
+    double duracao = tempoAgora() - inicio;
+
+    printf("📼 Sequência de %s\n", caminho);
+    printf("Semente: %llu | Jogo: %llu | Peças: %llu | %u bits por peça | %.1f MB mapeados\n",
+           (unsigned long long)cabecalho->semente, (unsigned long long)cabecalho->jogo,
+           (unsigned long long)sequencia.total_pecas, cabecalho->bits_por_peca, sequencia.tamanho_mapa / 1e6);
+    printf("---------------------------------------------------\n");
+    printf("Páginas na cache do kernel: %.1f%% antes da leitura | %.1f%% depois\n", 100.0 * residente_antes,
+           100.0 * fracaoResidente(&sequencia));
+    printf("Leitura: %.3f s | %.1f milhões de peças/s | %.1f MB/s\n", duracao, sequencia.total_pecas / duracao / 1e6,
+           sequencia.tamanho_mapa / duracao / 1e6);
+    printf("Tipos:");
+    for (int t = 0; t < NUM_TIPOS_PECA; t++)
+    {
+        printf(" %c=%.3f%%", TIPOS_PECA[t], 100.0 * contagem[t] / (double)sequencia.total_pecas);
+    }
+    printf("\n");
+
+    // Conferência (fora da medição): bloco a bloco contra o gerador puro do cabeçalho
+    GeradorPecas puro;
+    Peca esperado[BLOCO_ANALISE];
+    uint64_t divergencias = 0;
+    inicializarGeradorComArquivo(&gerador, &sequencia);
+    inicializarGerador(&puro, cabecalho->semente, cabecalho->jogo);
+    while (gerador.posicao < sequencia.total_pecas)
+    {
+        uint64_t restantes = sequencia.total_pecas - gerador.posicao;
+        int n = restantes < BLOCO_ANALISE ? (int)restantes : BLOCO_ANALISE;
+        gerarPecasLote(&gerador, bloco, n);
+        gerarPecasLote(&puro, esperado, n);
+        for (int i = 0; i < n; i++)
+        {
+            divergencias += bloco[i].nome[0] != esperado[i].nome[0];
+        }
+    }
+    fecharSequenciaArquivo(&sequencia);
+
+    if (divergencias > 0)
+    {
+        printf("❌ %llu peças diferem do gerador da semente do cabeçalho.\n", (unsigned long long)divergencias);
+        return 1;
+    }
+    printf("✅ Todas as peças conferem com o gerador da semente do cabeçalho.\n");
+    return 0;
+}
+#else
+int executarGeracaoSequencia(const char *caminho, uint64_t semente, uint64_t jogo, uint64_t total, int bits)
+{
+    (void)semente;
+    (void)jogo;
+    (void)total;
+    (void)bits;
+    printf("❌ Arquivos de sequência (%s) só estão disponíveis no Linux.\n", caminho);
+    return 1;
+}
+
+int executarLeituraSequencia(const char *caminho)
+{
+    printf("❌ Arquivos de sequência (%s) só estão disponíveis no Linux.\n", caminho);
+    return 1;
+}
+#endif
@@ -0,0 +1,324 @@
+// Gerador de carga para o servidor de sessões (desafio-mestre --servidor CAMINHO)
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+
+#include "protocolo-sessoes.h"
+
+#define TAMANHO_PROMPT (sizeof(PROMPT_MENU) - 1)
+#define EVENTOS_POR_ESPERA 512
+
+/**
+ * @struct ClienteCarga
+ * Um cliente simulado: conecta, espera o menu, envia uma opção por vez e mede quanto tempo
+ * a resposta inteira (até o próximo PROMPT_MENU) leva para chegar.
+ */
+typedef struct
+{
+    int descritor;
+    int conectado;
+    int acoes_feitas;
+    int saindo;       // Enviou "0" e espera o servidor fechar
+    double envio;     // Instante em que a última opção foi enviada
+    double agendado;  // Instante em que a próxima opção deve sair (tempo de "pensar" do jogador)
+    char cauda[TAMANHO_PROMPT]; // Últimos bytes recebidos, para reconhecer o prompt
+    size_t tamanho_cauda;
+} ClienteCarga;
+
+static double tempoAgora()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t misturarBits(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static int compararDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Acrescenta bytes recebidos à cauda e diz se ela agora termina com o prompt do menu
+static int recebeuPrompt(ClienteCarga *cliente, const char *dados, size_t n)
+{
+    if (n >= TAMANHO_PROMPT)
+    {
+        memcpy(cliente->cauda, dados + n - TAMANHO_PROMPT, TAMANHO_PROMPT);
+        cliente->tamanho_cauda = TAMANHO_PROMPT;
+    }
+    else
+    {
+        size_t manter = cliente->tamanho_cauda + n > TAMANHO_PROMPT ? TAMANHO_PROMPT - n : cliente->tamanho_cauda;
+        memmove(cliente->cauda, cliente->cauda + cliente->tamanho_cauda - manter, manter);
+        memcpy(cliente->cauda + manter, dados, n);
+        cliente->tamanho_cauda = manter + n;
+    }
+    return cliente->tamanho_cauda == TAMANHO_PROMPT && memcmp(cliente->cauda, PROMPT_MENU, TAMANHO_PROMPT) == 0;
+}
+
+static int conectar(ClienteCarga *cliente, const struct sockaddr_un *endereco, int epoll)
+{
+    int descritor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (descritor < 0)
+    {
+        return -1;
+    }
+    if (connect(descritor, (const struct sockaddr *)endereco, sizeof(*endereco)) != 0)
+    {
+        int erro = errno;
+        close(descritor);
+        return erro == EAGAIN ? 0 : -1; // EAGAIN: fila de conexões do servidor cheia, tenta depois
+    }
+
+    memset(cliente, 0, sizeof(*cliente));
+    cliente->descritor = descritor;
+    cliente->conectado = 1;
+
+    struct epoll_event evento;
+    evento.events = EPOLLIN;
+    evento.data.ptr = cliente;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, descritor, &evento);
+    return 1;
+}
+
+static void enviarOpcao(ClienteCarga *cliente, int opcao)
+{
+    char linha[4] = {(char)('0' + opcao), '\n', '\0', '\0'};
+    cliente->envio = tempoAgora();
+    if (send(cliente->descritor, linha, 2, MSG_NOSIGNAL) != 2)
+    {
+        cliente->saindo = 1; // Conexão com problema: será fechada quando o servidor desistir
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *caminho = CAMINHO_SOCKET_PADRAO;
+    int total_clientes = 10000;
+    int acoes_por_cliente = 20;
+    uint64_t semente = 1;
+    int pausa_ms = 0;
+
+    // Argumentos opcionais:
+    //   --caminho CAMINHO  socket do servidor
+    //   --clientes N       conexões simultâneas (todas abertas antes da primeira opção)
+    //   --acoes A          opções enviadas por cliente antes de sair com "0"
+    //   --semente S        escolhe a sequência de opções de cada cliente
+    //   --pausa MS         tempo de "pensar" entre a resposta e a próxima opção (0 = sem pausa)
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--caminho") == 0)
+        {
+            caminho = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--clientes") == 0)
+        {
+            total_clientes = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--acoes") == 0)
+        {
+            acoes_por_cliente = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--semente") == 0)
+        {
+            semente = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--pausa") == 0)
+        {
+            pausa_ms = atoi(argv[i + 1]);
+        }
+    }
+    if (total_clientes < 1 || acoes_por_cliente < 1 || pausa_ms < 0)
+    {
+        printf("❌ --clientes e --acoes precisam ser positivos e --pausa não pode ser negativa.\n");
+        return 1;
+    }
+
+    struct rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0)
+    {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    snprintf(endereco.sun_path, sizeof(endereco.sun_path), "%s", caminho);
+
+    ClienteCarga *clientes = calloc(total_clientes, sizeof(ClienteCarga));
+    double *latencias = malloc((size_t)total_clientes * acoes_por_cliente * sizeof(double));
+    int *agenda = malloc((size_t)total_clientes * sizeof(int));
+    if (clientes == NULL || latencias == NULL || agenda == NULL)
+    {
+        printf("❌ Memória insuficiente para %d clientes.\n", total_clientes);
+        return 1;
+    }
+
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0)
+    {
+        perror("epoll_create1");
+        return 1;
+    }
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
+    int conectados = 0, com_menu = 0, encerrados = 0, falhas = 0;
+    size_t total_latencias = 0;
+    double inicio_conexoes = tempoAgora();
+    double inicio_acoes = 0.0;
+    double pausa = pausa_ms / 1e3;
+
+    // Agenda de envios: como a pausa é a mesma para todos, os clientes entram em ordem de
+    // horário e uma fila circular simples basta (a frente é sempre o próximo a enviar)
+    int agenda_inicio = 0, agenda_tamanho = 0;
+
+    // Fase 1: abre todas as conexões e espera o menu inicial de cada uma.
+    // Fase 2: quando todos têm o menu, cada cliente envia uma opção, espera a resposta e a pausa.
+    while (encerrados + falhas < total_clientes)
+    {
+        while (conectados + falhas < total_clientes)
+        {
+            int resultado = conectar(&clientes[conectados + falhas], &endereco, epoll);
+            if (resultado == 0)
+            {
+                break;
+            }
+            if (resultado < 0)
+            {
+                perror("connect");
+                falhas++;
+                continue;
+            }
+            conectados++;
+        }
+
+        if (inicio_acoes == 0.0 && com_menu == total_clientes - falhas)
+        {
+            // Primeiras opções espalhadas ao longo de uma pausa, para não chegarem todas juntas
+            inicio_acoes = tempoAgora();
+            for (int i = 0; i < total_clientes; i++)
+            {
+                if (clientes[i].conectado)
+                {
+                    clientes[i].agendado = inicio_acoes + pausa * i / total_clientes;
+                    agenda[(agenda_inicio + agenda_tamanho++) % total_clientes] = i;
+                }
+            }
+        }
+
+        double agora = tempoAgora();
+        while (agenda_tamanho > 0 && clientes[agenda[agenda_inicio]].agendado <= agora)
+        {
+            ClienteCarga *cliente = &clientes[agenda[agenda_inicio]];
+            agenda_inicio = (agenda_inicio + 1) % total_clientes;
+            agenda_tamanho--;
+            if (cliente->acoes_feitas < acoes_por_cliente)
+            {
+                uint64_t sorteio = misturarBits(semente ^ ((uint64_t)(cliente - clientes) << 20) ^ (uint64_t)cliente->acoes_feitas);
+                enviarOpcao(cliente, 1 + (int)(sorteio % 7));
+            }
+            else
+            {
+                enviarOpcao(cliente, 0);
+                cliente->saindo = 1;
+            }
+        }
+
+        int espera_ms = 1000;
+        if (agenda_tamanho > 0)
+        {
+            espera_ms = (int)((clientes[agenda[agenda_inicio]].agendado - agora) * 1e3) + 1;
+        }
+        int prontos = epoll_wait(epoll, eventos, EVENTOS_POR_ESPERA, espera_ms);
+        if (prontos == 0 && inicio_acoes == 0.0 && com_menu == 0)
+        {
+            printf("❌ O servidor não respondeu em 1 s.\n");
+            return 1;
+        }
+
+        for (int e = 0; e < prontos; e++)
+        {
+            ClienteCarga *cliente = eventos[e].data.ptr;
+            char dados[4096];
+            ssize_t n = recv(cliente->descritor, dados, sizeof(dados), 0);
+
+            if (n <= 0)
+            {
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    continue;
+                }
+                // Servidor fechou: esperado depois do "0"
+                epoll_ctl(epoll, EPOLL_CTL_DEL, cliente->descritor, NULL);
+                close(cliente->descritor);
+                cliente->conectado = 0;
+                if (cliente->saindo)
+                {
+                    encerrados++;
+                }
+                else
+                {
+                    falhas++;
+                    conectados--;
+                }
+                continue;
+            }
+
+            if (!recebeuPrompt(cliente, dados, (size_t)n))
+            {
+                continue;
+            }
+
+            if (inicio_acoes == 0.0)
+            {
+                com_menu++; // Menu inicial; a primeira opção sai quando todos estiverem prontos
+                continue;
+            }
+
+            double chegada = tempoAgora();
+            latencias[total_latencias++] = chegada - cliente->envio;
+            cliente->acoes_feitas++;
+            cliente->agendado = chegada + pausa;
+            agenda[(agenda_inicio + agenda_tamanho++) % total_clientes] = (int)(cliente - clientes);
+        }
+    }
+    double fim = tempoAgora();
+
+    qsort(latencias, total_latencias, sizeof(double), compararDouble);
+    printf("📶 Carga no Servidor de Sessões (%s)\n", caminho);
+    printf("Clientes simultâneos: %d | Falhas: %d | Opções por cliente: %d | Pausa: %d ms\n",
+           total_clientes - falhas, falhas, acoes_por_cliente, pausa_ms);
+    printf("---------------------------------------------------\n");
+    printf("Conexão de todos os clientes: %.3f s\n", inicio_acoes - inicio_conexoes);
+    if (total_latencias > 0)
+    {
+        printf("Latência por opção: p50 %.3f ms | p99 %.3f ms | p99,9 %.3f ms | máx %.3f ms\n",
+               latencias[total_latencias / 2] * 1e3, latencias[(size_t)(total_latencias * 0.99)] * 1e3,
+               latencias[(size_t)(total_latencias * 0.999)] * 1e3, latencias[total_latencias - 1] * 1e3);
+        printf("Vazão: %.0f opções/s em %.3f s\n", total_latencias / (fim - inicio_acoes), fim - inicio_acoes);
+    }
+
+    free(agenda);
+    free(latencias);
+    free(clientes);
+    close(epoll);
+    return falhas > 0;
+}
@@ -0,0 +1,258 @@
+// Conferência e medição do ambiente de aprendizado (desafio-mestre --passos-ambiente N)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "motor.h"
+#include "ferramentas.h"
+#include "ambiente-rl.h"
+
+// --- Conferência do Ambiente de Aprendizado ---
+
+#define MAX_PARTIDAS_CONFERENCIA 64
+
+/**
+ * @struct BuffersProprios
+ * Buffers alocados pelo próprio binário, no papel do chamador da API.
+ */
+typedef struct
+{
+    BuffersAmbiente ponteiros;
+    uint8_t *acoes;
+} BuffersProprios;
+
+static int alocarBuffersAmbiente(BuffersProprios *proprios, int n)
+{
+    proprios->ponteiros.fila = malloc((size_t)n * AMBIENTE_TAMANHO_FILA);
+    proprios->ponteiros.pilha = malloc((size_t)n * AMBIENTE_TAMANHO_PILHA);
+    proprios->ponteiros.mascara = malloc((size_t)n * AMBIENTE_NUM_ACOES);
+    proprios->ponteiros.recompensa = malloc((size_t)n * sizeof(float));
+    proprios->ponteiros.terminado = malloc((size_t)n);
+    proprios->acoes = malloc((size_t)n);
+    return proprios->ponteiros.fila != NULL && proprios->ponteiros.pilha != NULL && proprios->ponteiros.mascara != NULL &&
+           proprios->ponteiros.recompensa != NULL && proprios->ponteiros.terminado != NULL && proprios->acoes != NULL;
+}
+
+static void liberarBuffersAmbiente(BuffersProprios *proprios)
+{
+    free(proprios->ponteiros.fila);
+    free(proprios->ponteiros.pilha);
+    free(proprios->ponteiros.mascara);
+    free(proprios->ponteiros.recompensa);
+    free(proprios->ponteiros.terminado);
+    free(proprios->acoes);
+}
+
+/**
+ * Confere a API contra o motor usado diretamente. Cada partida da API tem uma cópia-sombra
+ * que recebe as mesmas ações (inclusive inválidas e fora do intervalo); depois de cada passo,
+ * a observação precisa bater com a sombra: tipos lidos pela prévia, máscara igual a "a ação
+ * funciona numa cópia da partida" e recompensa pela regra de BuffersAmbiente, ação a ação.
+ * Retorna quantos passos foram conferidos, ou 0 se houve divergência.
+ */
+static uint64_t conferirAmbiente(uint64_t semente, int n, uint32_t passos_por_episodio)
+{
+    BuffersProprios proprios;
+    Jogo sombras[MAX_PARTIDAS_CONFERENCIA];
+    uint32_t passos[MAX_PARTIDAS_CONFERENCIA] = {0};
+    uint64_t proximo_jogo = (uint64_t)n;
+    uint64_t conferidos = 0;
+    const char *erro = NULL;
+
+    AmbienteTetris *ambiente = NULL;
+    if (alocarBuffersAmbiente(&proprios, n))
+    {
+        ambiente = ambienteCriar(n, passos_por_episodio, &proprios.ponteiros);
+    }
+    if (ambiente == NULL)
+    {
+        liberarBuffersAmbiente(&proprios);
+        printf("❌ Memória insuficiente para conferir o ambiente.\n");
+        return 0;
+    }
+    ambienteReiniciar(ambiente, semente);
+    for (int i = 0; i < n; i++)
+    {
+        inicializarJogo(&sombras[i], semente, (uint64_t)i);
+    }
+
+    uint64_t total_passos = 4 * (uint64_t)passos_por_episodio + 16;
+    for (uint64_t passo = 0; passo < total_passos && erro == NULL; passo++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            proprios.acoes[i] = (uint8_t)(misturarBits(semente ^ (passo << 16) ^ (uint64_t)i) % (AMBIENTE_NUM_ACOES + 1));
+        }
+        ambienteAvancar(ambiente, proprios.acoes, n);
+
+        for (int i = 0; i < n && erro == NULL; i++)
+        {
+            Jogo *sombra = &sombras[i];
+            float recompensa = -1.0f;
+            if (proprios.acoes[i] < AMBIENTE_NUM_ACOES)
+            {
+                TipoOperacao desfeita = sombra->ultima_operacao;
+                if (executarAcao(sombra, (Acao)(ACAO_JOGAR + proprios.acoes[i])) == RESULTADO_OK)
+                {
+                    int colocou = proprios.acoes[i] == AMBIENTE_JOGAR || proprios.acoes[i] == AMBIENTE_USAR;
+                    int devolveu = proprios.acoes[i] == AMBIENTE_DESFAZER && desfeita == OP_JOGAR;
+                    recompensa = (float)(colocou - devolveu);
+                }
+            }
+            uint8_t terminado = 0;
+            if (++passos[i] >= passos_por_episodio)
+            {
+                inicializarJogo(sombra, semente, proximo_jogo++);
+                passos[i] = 0;
+                terminado = 1;
+            }
+
+            const uint8_t *fila = proprios.ponteiros.fila + (size_t)i * AMBIENTE_TAMANHO_FILA;
+            const uint8_t *pilha = proprios.ponteiros.pilha + (size_t)i * AMBIENTE_TAMANHO_PILHA;
+            const uint8_t *mascara = proprios.ponteiros.mascara + (size_t)i * AMBIENTE_NUM_ACOES;
+            if (proprios.ponteiros.recompensa[i] != recompensa)
+            {
+                erro = "recompensa";
+            }
+            if (proprios.ponteiros.terminado[i] != terminado)
+            {
+                erro = "fim de episódio";
+            }
+            for (int j = 0; j < CAPACIDADE_FILA; j++)
+            {
+                if (fila[j] != indiceTipoPeca(espiarPreviaJogo(sombra, (uint64_t)j)))
+                {
+                    erro = "tipos da fila";
+                }
+            }
+            for (int j = 0; j < CAPACIDADE_PILHA; j++)
+            {
+                int esperado = j <= sombra->pilha.topo ? indiceTipoPeca(sombra->pilha.itens[sombra->pilha.topo - j])
+                                                       : AMBIENTE_TIPO_VAZIO;
+                if (pilha[j] != esperado)
+                {
+                    erro = "tipos da pilha";
+                }
+            }
+            for (int a = 0; a < AMBIENTE_NUM_ACOES; a++)
+            {
+                Jogo copia = *sombra;
+                if (mascara[a] != (executarAcao(&copia, (Acao)(ACAO_JOGAR + a)) == RESULTADO_OK))
+                {
+                    erro = "máscara de ações";
+                }
+            }
+            if (erro != NULL)
+            {
+                printf("❌ Divergência na %s da partida %d no passo %llu.\n", erro, i, (unsigned long long)passo);
+            }
+        }
+        conferidos += (uint64_t)n;
+    }
+
+    ambienteDestruir(ambiente);
+    liberarBuffersAmbiente(&proprios);
+    return erro == NULL ? conferidos : 0;
+}
+
+/**
+ * Mede a API como um laço de treino a usaria: a cada passo, uma política aleatória escolhe
+ * uma ação válida pela máscara de cada partida e o lote inteiro avança numa chamada. Só as
+ * chamadas a ambienteAvancar entram no tempo; a assinatura das observações (calculada fora
+ * do tempo) deve ser igual em qualquer build.
+ */
+int executarAmbiente(uint64_t semente, uint64_t total_passos, int n_ambientes, int passos_por_episodio)
+{
+    if (n_ambientes < 1 || passos_por_episodio < 1)
+    {
+        printf("❌ --ambientes e --acoes precisam ser positivos.\n");
+        return 1;
+    }
+
+    printf("🤖 Ambiente de Aprendizado por Reforço (API em lote)\n");
+    printf("Semente: %llu | Partidas por lote: %d | Passos por episódio: %d\n", (unsigned long long)semente, n_ambientes,
+           passos_por_episodio);
+    printf("---------------------------------------------------\n");
+
+    int partidas_conferencia = n_ambientes < MAX_PARTIDAS_CONFERENCIA ? n_ambientes : MAX_PARTIDAS_CONFERENCIA;
+    uint64_t conferidos = conferirAmbiente(semente, partidas_conferencia, (uint32_t)passos_por_episodio);
+    if (conferidos == 0)
+    {
+        return 1;
+    }
+    printf("✅ API igual ao motor em %llu passos de %d partidas (ações inválidas incluídas).\n",
+           (unsigned long long)conferidos, partidas_conferencia);
+
+    BuffersProprios proprios;
+    AmbienteTetris *ambiente = NULL;
+    if (alocarBuffersAmbiente(&proprios, n_ambientes))
+    {
+        ambiente = ambienteCriar(n_ambientes, (uint32_t)passos_por_episodio, &proprios.ponteiros);
+    }
+    if (ambiente == NULL)
+    {
+        liberarBuffersAmbiente(&proprios);
+        printf("❌ Memória insuficiente para %d partidas.\n", n_ambientes);
+        return 1;
+    }
+    ambienteReiniciar(ambiente, semente);
+
+    uint64_t lotes = (total_passos + (uint64_t)n_ambientes - 1) / (uint64_t)n_ambientes;
+    uint64_t assinatura = 0, episodios = 0, sorteios = 0;
+    double soma_recompensas = 0.0, tempo = 0.0;
+    for (uint64_t lote = 0; lote < lotes; lote++)
+    {
+        for (int i = 0; i < n_ambientes; i++)
+        {
+            const uint8_t *mascara = proprios.ponteiros.mascara + (size_t)i * AMBIENTE_NUM_ACOES;
+            int validas = 0;
+            for (int a = 0; a < AMBIENTE_NUM_ACOES; a++)
+            {
+                validas += mascara[a];
+            }
+            int escolhida = (int)(misturarBits(semente + sorteios++) % (uint64_t)validas);
+            int acao = 0;
+            while (!mascara[acao] || escolhida-- > 0)
+            {
+                acao++;
+            }
+            proprios.acoes[i] = (uint8_t)acao;
+        }
+
+        double inicio = tempoAgora();
+        ambienteAvancar(ambiente, proprios.acoes, n_ambientes);
+        tempo += tempoAgora() - inicio;
+
+        for (int i = 0; i < n_ambientes; i++)
+        {
+            const uint8_t *fila = proprios.ponteiros.fila + (size_t)i * AMBIENTE_TAMANHO_FILA;
+            const uint8_t *pilha = proprios.ponteiros.pilha + (size_t)i * AMBIENTE_TAMANHO_PILHA;
+            uint64_t observacao = 0;
+            for (int j = 0; j < AMBIENTE_TAMANHO_FILA; j++)
+            {
+                observacao = observacao << 3 | fila[j];
+            }
+            for (int j = 0; j < AMBIENTE_TAMANHO_PILHA; j++)
+            {
+                observacao = observacao << 3 | pilha[j];
+            }
+            observacao = observacao << 8 | (uint64_t)(int8_t)proprios.ponteiros.recompensa[i];
+            assinatura = misturarBits(assinatura ^ observacao);
+            soma_recompensas += proprios.ponteiros.recompensa[i];
+            episodios += proprios.ponteiros.terminado[i];
+        }
+    }
+    uint64_t passos = lotes * (uint64_t)n_ambientes;
+
+    printf("Passos: %llu em %.3f s | %.1f milhões de passos/s | %.1f ns por passo\n", (unsigned long long)passos, tempo,
+           passos / tempo / 1e6, tempo / passos * 1e9);
+    printf("Episódios concluídos: %llu | Recompensa média por passo: %.4f\n", (unsigned long long)episodios,
+           soma_recompensas / passos);
+    printf("Assinatura das observações: %016llx\n", (unsigned long long)assinatura);
+
+    ambienteDestruir(ambiente);
+    liberarBuffersAmbiente(&proprios);
+    return 0;
+}
@@ -1,577 +1,5570 @@
+// Nível Mestre do Tetris Stack: jogo no terminal e modos de ferramenta (o motor fica em motor.c)
+// Extensões GNU: memmem, pipe2 e environ (partida fria)
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <math.h>
+#include <stdarg.h>
 
-// --- 1. Definições e Estruturas de Dados ---
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
-#define CAPACIDADE_FILA 5
-#define CAPACIDADE_PILHA 3
+#ifdef __linux__
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <errno.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#endif
 
-/**
- * @struct Peca
- */
-typedef struct
-{
-    int id;
-    char nome[2];
-} Peca;
+#include "estado-publicado.h"
+#include "protocolo-sessoes.h"
+#include "motor.h"
+#include "ferramentas.h"
 
-/**
- * @struct FilaCircular (Next Queue)
- */
-typedef struct
-{
-    Peca itens[CAPACIDADE_FILA];
-    int frente;
-    int traseira;
-    int tamanho;
-} FilaCircular;
+// --- 7. Modos de Ferramenta (execução sem menu) ---
 
 /**
- * @struct Pilha (Hold Stack)
+ * @struct FatiaAnalise
+ * Trecho [inicio, fim) da sequência analisado por uma thread e seus resultados parciais.
+ * As secas (maior intervalo sem um tipo) são combinadas entre fatias usando a primeira e a
+ * última ocorrência de cada tipo dentro da fatia.
  */
 typedef struct
 {
-    Peca itens[CAPACIDADE_PILHA];
-    int topo;
-} Pilha;
+    uint64_t semente;
+    uint64_t jogo;
+    uint64_t inicio;
+    uint64_t fim;
 
-// --- Estrutura e Variáveis Globais de HISTÓRICO (para a função Desfazer) ---
+    uint64_t contagem[NUM_TIPOS_PECA];
+    int64_t primeira[NUM_TIPOS_PECA]; // -1 se o tipo não apareceu na fatia
+    int64_t ultima[NUM_TIPOS_PECA];
+    uint64_t maior_seca[NUM_TIPOS_PECA]; // Maior seca inteiramente dentro da fatia
+} FatiaAnalise;
 
-// Tipo de operação que ocorreu
-typedef enum
+static void *analisarFatia(void *argumento)
 {
-    OP_NENHUMA,
-    OP_JOGAR,
-    OP_RESERVAR
-    // Para simplificar, Desfazer focará apenas nas operações que alteram ambas
-} TipoOperacao;
-
-// Variáveis para salvar o estado da última operação JOGAR ou RESERVAR
-TipoOperacao ultima_operacao = OP_NENHUMA;
-Peca peca_historico_jogada = {-1, "XX"}; // Peça que foi jogada/reservada
-Peca peca_historico_nova = {-1, "XX"};   // Peça nova que foi gerada e inserida
+    FatiaAnalise *fatia = argumento;
+    GeradorPecas gerador;
+    Peca bloco[BLOCO_ANALISE];
 
-// --- 2. Variável e Função de Geração de Peças ---
+    // Converte a letra do tipo de volta para o índice em TIPOS_PECA
+    int indice_por_letra[256] = {0};
+    for (int t = 0; t < NUM_TIPOS_PECA; t++)
+    {
+        indice_por_letra[(unsigned char)TIPOS_PECA[t]] = t;
+        fatia->primeira[t] = -1;
+        fatia->ultima[t] = -1;
+    }
 
-static int proximo_id = 1;
+    inicializarGerador(&gerador, fatia->semente, fatia->jogo);
+    posicionarGerador(&gerador, fatia->inicio);
 
-Peca gerarPeca()
-{
-    Peca nova_peca;
-    nova_peca.id = proximo_id++;
+    // Só um bloco de peças fica em memória: a sequência nunca é armazenada inteira
+    for (uint64_t posicao = fatia->inicio; posicao < fatia->fim; posicao += BLOCO_ANALISE)
+    {
+        uint64_t restantes = fatia->fim - posicao;
+        int n = restantes < BLOCO_ANALISE ? (int)restantes : BLOCO_ANALISE;
+        gerarPecasLote(&gerador, bloco, n);
 
-    const char *tipos[] = {"I", "O", "T", "L", "J", "S", "Z"};
-    int num_tipos = sizeof(tipos) / sizeof(tipos[0]);
+        for (int i = 0; i < n; i++)
+        {
+            int t = indice_por_letra[(unsigned char)bloco[i].nome[0]];
+            int64_t atual = (int64_t)(posicao + i);
 
-    int indice_aleatorio = rand() % num_tipos;
-    strcpy(nova_peca.nome, tipos[indice_aleatorio]);
+            fatia->contagem[t]++;
+            if (fatia->ultima[t] < 0)
+            {
+                fatia->primeira[t] = atual;
+            }
+            else if ((uint64_t)(atual - fatia->ultima[t] - 1) > fatia->maior_seca[t])
+            {
+                fatia->maior_seca[t] = (uint64_t)(atual - fatia->ultima[t] - 1);
+            }
+            fatia->ultima[t] = atual;
+        }
+    }
 
-    return nova_peca;
+    return NULL;
 }
 
-Peca criarPecaErro()
+/**
+ * Gera total_pecas peças do jogo em paralelo e relata frequências por tipo, maiores secas,
+ * a estatística qui-quadrado contra a distribuição uniforme e a vazão do gerador.
+ * Usa memória constante: cada thread mantém só um bloco de peças e seus contadores.
+ */
+int executarAnaliseDistribuicao(uint64_t semente, uint64_t jogo, uint64_t total_pecas, int num_threads)
 {
-    Peca peca_erro = {-1, "XX"};
-    return peca_erro;
-}
-
-// --- 3. Funções da FILA CIRCULAR ---
+    if (total_pecas == 0)
+    {
+        printf("❌ Informe uma quantidade de peças maior que zero.\n");
+        return 1;
+    }
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS)
+    {
+        num_threads = MAX_THREADS;
+    }
 
-void inicializarFila(FilaCircular *fila)
-{
-    fila->frente = 0;
-    fila->traseira = 0;
-    fila->tamanho = 0;
-}
+    FatiaAnalise fatias[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    memset(fatias, 0, sizeof(fatias));
 
-int filaCheia(const FilaCircular *fila)
-{
-    return fila->tamanho == CAPACIDADE_FILA;
-}
+    double inicio = tempoAgora();
 
-int filaVazia(const FilaCircular *fila)
-{
-    return fila->tamanho == 0;
-}
+    uint64_t por_thread = total_pecas / num_threads;
+    for (int i = 0; i < num_threads; i++)
+    {
+        fatias[i].semente = semente;
+        fatias[i].jogo = jogo;
+        fatias[i].inicio = i * por_thread;
+        fatias[i].fim = (i == num_threads - 1) ? total_pecas : (i + 1) * por_thread;
+        int erro = pthread_create(&threads[i], NULL, analisarFatia, &fatias[i]);
+        if (erro != 0)
+        {
+            printf("❌ Não foi possível criar a thread %d de %d: %s\n", i + 1, num_threads, strerror(erro));
+            for (int j = 0; j < i; j++)
+            {
+                pthread_join(threads[j], NULL);
+            }
+            return 1;
+        }
+    }
 
-int enfileirar(FilaCircular *fila, Peca peca)
-{
-    if (filaCheia(fila))
+    // Combina as fatias na ordem da sequência
+    uint64_t contagem[NUM_TIPOS_PECA] = {0};
+    uint64_t maior_seca[NUM_TIPOS_PECA] = {0};
+    int64_t ultima[NUM_TIPOS_PECA];
+    for (int t = 0; t < NUM_TIPOS_PECA; t++)
     {
-        return 0;
+        ultima[t] = -1;
     }
-    fila->itens[fila->traseira] = peca;
-    fila->traseira = (fila->traseira + 1) % CAPACIDADE_FILA;
-    fila->tamanho++;
-    return 1;
-}
 
-Peca desenfileirar(FilaCircular *fila)
-{
-    if (filaVazia(fila))
+    for (int i = 0; i < num_threads; i++)
     {
-        return criarPecaErro();
+        pthread_join(threads[i], NULL);
+
+        for (int t = 0; t < NUM_TIPOS_PECA; t++)
+        {
+            contagem[t] += fatias[i].contagem[t];
+            if (fatias[i].primeira[t] < 0)
+            {
+                continue;
+            }
+            uint64_t seca_na_fronteira = (uint64_t)(fatias[i].primeira[t] - ultima[t] - 1);
+            if (seca_na_fronteira > maior_seca[t])
+            {
+                maior_seca[t] = seca_na_fronteira;
+            }
+            if (fatias[i].maior_seca[t] > maior_seca[t])
+            {
+                maior_seca[t] = fatias[i].maior_seca[t];
+            }
+            ultima[t] = fatias[i].ultima[t];
+        }
     }
-    Peca peca_removida = fila->itens[fila->frente];
-    fila->frente = (fila->frente + 1) % CAPACIDADE_FILA;
-    fila->tamanho--;
-    return peca_removida;
-}
 
-// Obtém a peça da frente sem remover
-Peca espiarFila(const FilaCircular *fila)
-{
-    if (filaVazia(fila))
+    double duracao = tempoAgora() - inicio;
+
+    printf("📊 Análise da Distribuição de Peças\n");
+    printf("Semente: %llu | Jogo: %llu | Peças: %llu | Threads: %d\n",
+           (unsigned long long)semente, (unsigned long long)jogo,
+           (unsigned long long)total_pecas, num_threads);
+    printf("---------------------------------------------------\n");
+    printf(" Tipo | Quantidade      | Frequência | Maior seca\n");
+
+    double esperado = (double)total_pecas / NUM_TIPOS_PECA;
+    double qui_quadrado = 0.0;
+    for (int t = 0; t < NUM_TIPOS_PECA; t++)
     {
-        return criarPecaErro();
+        // A seca final vai da última ocorrência até o fim da sequência
+        uint64_t seca_final = (uint64_t)((int64_t)total_pecas - ultima[t] - 1);
+        if (seca_final > maior_seca[t])
+        {
+            maior_seca[t] = seca_final;
+        }
+
+        double diferenca = contagem[t] - esperado;
+        qui_quadrado += diferenca * diferenca / esperado;
+
+        printf("  %c   | %15llu | %9.5f%% | %llu\n", TIPOS_PECA[t],
+               (unsigned long long)contagem[t], 100.0 * contagem[t] / total_pecas,
+               (unsigned long long)maior_seca[t]);
     }
-    return fila->itens[fila->frente];
-}
 
-// Obtém o índice anterior à frente (para desfazer)
-int obterIndiceAnteriorFrente(const FilaCircular *fila)
-{
-    return (fila->frente - 1 + CAPACIDADE_FILA) % CAPACIDADE_FILA;
-}
+    printf("---------------------------------------------------\n");
+    // Valor crítico da qui-quadrado com 6 graus de liberdade a 5% de significância
+    printf("Qui-quadrado (6 g.l.): %.3f (limite 5%%: 12.592) -> %s\n", qui_quadrado,
+           qui_quadrado <= 12.592 ? "compatível com distribuição uniforme" : "distribuição NÃO uniforme");
+    printf("Tempo: %.3f s | Vazão: %.1f milhões de peças/s\n", duracao, total_pecas / duracao / 1e6);
 
-// Obtém o índice anterior à traseira (última peça inserida)
-int obterIndiceAnteriorTraseira(const FilaCircular *fila)
-{
-    return (fila->traseira - 1 + CAPACIDADE_FILA) % CAPACIDADE_FILA;
+    return 0;
 }
 
-// --- 4. Funções da PILHA LINEAR ---
+// --- Contagem de alocações (interposição de malloc/free na glibc) ---
 
-void inicializarPilha(Pilha *pilha)
-{
-    pilha->topo = -1;
-}
+// Só existe na build de verificação (make alocacoes, -DTETRIS_CONTAGEM_ALOCACOES): trocar o
+// malloc do processo custa uma checagem em cada alocação de todos os modos, e nas builds de
+// release, estática, de fuzzing e da biblioteca do ambiente o malloc fica com a libc
+#if defined(TETRIS_CONTAGEM_ALOCACOES) && defined(__GLIBC__)
+#define CONTAGEM_ALOCACOES_DISPONIVEL 1
 
-int pilhaCheia(const Pilha *pilha)
-{
-    return pilha->topo == CAPACIDADE_PILHA - 1;
-}
+extern void *__libc_malloc(size_t tamanho);
+extern void *__libc_calloc(size_t quantidade, size_t tamanho);
+extern void *__libc_realloc(void *ponteiro, size_t tamanho);
+extern void *__libc_memalign(size_t alinhamento, size_t tamanho);
+extern void __libc_free(void *ponteiro);
 
-int pilhaVazia(const Pilha *pilha)
-{
-    return pilha->topo == -1;
-}
+// Só é ligada por modos de uma única thread, durante o trecho medido
+static volatile int contar_alocacoes = 0;
+static uint64_t alocacoes_contadas = 0;
+static uint64_t liberacoes_contadas = 0;
 
-int empilhar(Pilha *pilha, Peca peca)
+void *malloc(size_t tamanho)
 {
-    if (pilhaCheia(pilha))
+    if (contar_alocacoes)
     {
-        return 0;
+        alocacoes_contadas++;
     }
-    pilha->topo++;
-    pilha->itens[pilha->topo] = peca;
-    return 1;
+    return __libc_malloc(tamanho);
 }
 
-Peca desempilhar(Pilha *pilha)
+void *calloc(size_t quantidade, size_t tamanho)
 {
-    if (pilhaVazia(pilha))
+    if (contar_alocacoes)
     {
-        return criarPecaErro();
+        alocacoes_contadas++;
     }
-    Peca peca_removida = pilha->itens[pilha->topo];
-    pilha->topo--;
-    return peca_removida;
+    return __libc_calloc(quantidade, tamanho);
 }
 
-// Obtém a peça do topo sem remover
-Peca espiarPilha(const Pilha *pilha)
+void *realloc(void *ponteiro, size_t tamanho)
 {
-    if (pilhaVazia(pilha))
+    if (contar_alocacoes)
     {
-        return criarPecaErro();
+        alocacoes_contadas++;
     }
-    return pilha->itens[pilha->topo];
+    return __libc_realloc(ponteiro, tamanho);
 }
 
-// --- 5. Funções de Visualização e Inicialização ---
-
-void visualizarFila(const FilaCircular *fila)
+void *aligned_alloc(size_t alinhamento, size_t tamanho)
 {
-    printf("\n Fila de Peças Futuras (Tamanho: %d/%d) \n", fila->tamanho, CAPACIDADE_FILA);
-
-    if (filaVazia(fila))
+    if (contar_alocacoes)
     {
-        printf(" A fila está vazia.\n");
-        return;
+        alocacoes_contadas++;
     }
+    return __libc_memalign(alinhamento, tamanho);
+}
 
-    int i = fila->frente;
-    int count = 0;
-    printf(" Frente (Próxima) -> ");
-
-    while (count < fila->tamanho)
+void *memalign(size_t alinhamento, size_t tamanho)
+{
+    if (contar_alocacoes)
     {
-        printf("[ID:%d|%s]", fila->itens[i].id, fila->itens[i].nome);
-
-        if (count < fila->tamanho - 1)
-        {
-            printf(" -> ");
-        }
-
-        i = (i + 1) % CAPACIDADE_FILA;
-        count++;
+        alocacoes_contadas++;
     }
-
-    printf(" <- Traseira\n");
-    printf("---------------------------------------------------\n");
+    return __libc_memalign(alinhamento, tamanho);
 }
 
-void visualizarPilha(const Pilha *pilha)
+int posix_memalign(void **ponteiro, size_t alinhamento, size_t tamanho)
 {
-    printf("\n🔋 Pilha de Reserva (Tamanho: %d/%d) \n", pilha->topo + 1, CAPACIDADE_PILHA);
-
-    if (pilhaVazia(pilha))
+    if (contar_alocacoes)
     {
-        printf(" A pilha de reserva está vazia.\n");
-        printf("---------------------------------------------------\n");
-        return;
+        alocacoes_contadas++;
     }
-
-    printf(" Topo (Peça Reservada) -> ");
-    for (int i = pilha->topo; i >= 0; i--)
+    // Mesmas regras da glibc: potência de dois e múltiplo de sizeof(void *)
+    if (alinhamento % sizeof(void *) != 0 || (alinhamento & (alinhamento - 1)) != 0 || alinhamento == 0)
     {
-        printf("[ID:%d|%s]", pilha->itens[i].id, pilha->itens[i].nome);
-
-        if (i > 0)
-        {
-            printf(" | ");
-        }
+        return EINVAL;
     }
-    printf(" <- Base\n");
-    printf("---------------------------------------------------\n");
+    void *bloco = __libc_memalign(alinhamento, tamanho);
+    if (bloco == NULL)
+    {
+        return ENOMEM;
+    }
+    *ponteiro = bloco;
+    return 0;
 }
 
-void inicializarFilaAutomatica(FilaCircular *fila)
+void free(void *ponteiro)
 {
-    for (int i = 0; i < CAPACIDADE_FILA; i++)
+    if (contar_alocacoes && ponteiro != NULL)
     {
-        Peca nova = gerarPeca();
-        enfileirar(fila, nova);
+        liberacoes_contadas++;
     }
+    __libc_free(ponteiro);
 }
-
-// --- 6. Funções Estratégicas do Nível Mestre ---
+#endif
 
 /**
- * Troca a peça do topo da pilha com a peça da frente da fila.
+ * Mede o motor em regime permanente: jogar, reservar, usar, trocar, desfazer e inverter
+ * sorteados a partir da semente, sem nenhuma saída na tela dentro do laço medido.
+ * O tempo é medido por janelas de OPERACOES_POR_JANELA operações; latência estável
+ * aparece como p99 próximo de p50. Na build `make alocacoes`, falha (retorno 1) se houver
+ * qualquer alocação ou liberação depois da inicialização.
  */
-void trocarPilhaFila(FilaCircular *fila, Pilha *pilha)
+int executarBenchmarkMotor(uint64_t semente, uint64_t total_operacoes)
 {
-    Peca peca_fila = espiarFila(fila);
-    Peca peca_pilha = espiarPilha(pilha);
+    uint64_t janelas = total_operacoes / OPERACOES_POR_JANELA;
+    if (janelas == 0)
+    {
+        janelas = 1;
+    }
 
-    if (peca_fila.id == -1 || peca_pilha.id == -1)
+    // Toda a memória é reservada antes de o trecho medido começar
+    double *tempos = malloc(janelas * sizeof(double));
+    if (tempos == NULL)
     {
-        printf("❌ Erro: Uma das estruturas está vazia. Não é possível trocar.\n");
-        return;
+        printf("❌ Memória insuficiente para %llu janelas.\n", (unsigned long long)janelas);
+        return 1;
     }
 
-    // 1. Remove Logicamnte (Não usa desenfileirar/desempilhar para manter IDs)
-    Peca temp_fila = desenfileirar(fila);
-    Peca temp_pilha = desempilhar(pilha);
+    Jogo jogo;
+    inicializarJogo(&jogo, semente, 0);
 
-    // 2. Troca os itens
-    // Fila recebe o item da Pilha
-    enfileirar(fila, temp_pilha);
-    // Pilha recebe o item da Fila
-    empilhar(pilha, temp_fila);
+    uint64_t contador_acao = 0;
+    uint64_t falhas = 0;
+    uint64_t reinicios = 0;
 
-    // 3. Ajusta os índices para que o item empilhado vá para o topo
-    // E o item enfileirado vá para a frente (posição inicial)
-    // Isso é complexo na Circular. Vamos simplificar apenas trocando o conteúdo do índice
+#ifdef CONTAGEM_ALOCACOES_DISPONIVEL
+    alocacoes_contadas = 0;
+    liberacoes_contadas = 0;
+    contar_alocacoes = 1;
+#endif
 
-    // Desfaz o desenfileirar/enfileirar/desempilhar/empilhar, e faz a troca direta
-    // Reverter o desenfileirar/enfileirar para realizar a troca direta no array é mais seguro
+    for (uint64_t janela = 0; janela < janelas; janela++)
+    {
+        double inicio = tempoAgora();
+        for (int i = 0; i < OPERACOES_POR_JANELA; i++)
+        {
+            Acao acao = (Acao)(ACAO_JOGAR + misturarBits(semente + contador_acao++) % 6);
+            falhas += executarAcao(&jogo, acao) != RESULTADO_OK;
 
-    // A maneira mais simples e segura:
-    // A. Removo os dois
-    Peca front = desenfileirar(fila);
-    Peca top = desempilhar(pilha);
+            // Sem peças na fila e na pilha a partida não tem mais jogadas: começa outra
+            if (filaVazia(&jogo.fila) && pilhaVazia(&jogo.pilha))
+            {
+                inicializarJogo(&jogo, semente, ++reinicios);
+            }
+        }
+        tempos[janela] = tempoAgora() - inicio;
+    }
 
-    // B. Insiro o trocado
-    empilhar(pilha, front); // A peça da frente da fila vai para o topo da pilha
+#ifdef CONTAGEM_ALOCACOES_DISPONIVEL
+    contar_alocacoes = 0;
+    uint64_t alocacoes = alocacoes_contadas;
+    uint64_t liberacoes = liberacoes_contadas;
+#endif
 
-    // C. Enfileiro a peça da pilha na fila, mas preciso que ela vá para a posição FRENTE
-    // Para simplificar, ela vai para a traseira, mas isso não simula a troca "no lugar"
+    double total = 0.0;
+    for (uint64_t janela = 0; janela < janelas; janela++)
+    {
+        total += tempos[janela];
+    }
+    qsort(tempos, janelas, sizeof(double), compararDouble);
 
-    // Solução mais limpa: Troca de conteúdo
-    // 1. Copia o conteúdo da frente da fila
-    Peca temp_peca_fila = fila->itens[fila->frente];
+    double por_operacao = 1e9 / OPERACOES_POR_JANELA;
+    double p50 = tempos[janelas / 2] * por_operacao;
+    double p99 = tempos[(janelas * 99) / 100] * por_operacao;
+    double maximo = tempos[janelas - 1] * por_operacao;
 
-    // 2. Copia o conteúdo do topo da pilha
-    Peca temp_peca_pilha = pilha->itens[pilha->topo];
+    printf("⏱️  Benchmark do Motor (regime permanente)\n");
+    printf("Operações: %llu | Recusadas (fila/pilha vazia ou cheia): %llu | Partidas reiniciadas: %llu\n",
+           (unsigned long long)(janelas * OPERACOES_POR_JANELA), (unsigned long long)falhas,
+           (unsigned long long)reinicios);
+    printf("Latência por operação (janelas de %d): p50 %.2f ns | p99 %.2f ns | máx %.2f ns | p99/p50 %.2f\n",
+           OPERACOES_POR_JANELA, p50, p99, maximo, p99 / p50);
+    printf("Vazão: %.1f milhões de operações/s\n", janelas * OPERACOES_POR_JANELA / total / 1e6);
+    printf("Estado final: fila %d/%d, pilha %d/%d, próxima peça k=%llu\n",
+           jogo.fila.tamanho, CAPACIDADE_FILA, jogo.pilha.topo + 1, CAPACIDADE_PILHA,
+           (unsigned long long)jogo.gerador.posicao);
 
-    // 3. Faz a troca
-    fila->itens[fila->frente] = temp_peca_pilha;
-    pilha->itens[pilha->topo] = temp_peca_fila;
+    free(tempos);
 
-    printf("\n🔄 Troca Realizada:\n");
-    printf("   Fila (Frente): [ID:%d|%s] <- Novo\n", peca_pilha.id, peca_pilha.nome);
-    printf("   Pilha (Topo): [ID:%d|%s] <- Novo\n", peca_fila.id, peca_fila.nome);
+#ifdef CONTAGEM_ALOCACOES_DISPONIVEL
+    printf("No laço: %llu alocações (malloc/calloc/realloc/aligned_alloc/posix_memalign/memalign) | %llu liberações (free)\n",
+           (unsigned long long)alocacoes, (unsigned long long)liberacoes);
+    if (alocacoes > 0 || liberacoes > 0)
+    {
+        printf("❌ O motor alocou memória depois da inicialização.\n");
+        return 1;
+    }
+    printf("✅ Nenhuma alocação depois da inicialização.\n");
+#else
+    printf("⚠️ Contagem de alocações indisponível nesta build (use make alocacoes).\n");
+#endif
 
-    // Resetar histórico
-    ultima_operacao = OP_NENHUMA;
+    return 0;
 }
 
+// --- Verificação Diferencial (modelo de referência x motor) ---
+
 /**
- * Tenta reverter a última operação de JOGAR ou RESERVAR.
- * Nota: Implementação simplificada que desfaz o último Enqueue e reverte o Dequeue/PUSH.
+ * @struct ModeloReferencia
+ * Implementação ingênua das mesmas regras do motor, com arrays simples (a frente da fila
+ * está sempre em fila[0] e a base da pilha em pilha[0]). Serve de oráculo para o motor.
  */
-void desfazerUltimaJogada(FilaCircular *fila, Pilha *pilha)
+typedef struct
+{
+    Peca fila[CAPACIDADE_FILA];
+    int tamanho_fila;
+    Peca pilha[CAPACIDADE_PILHA];
+    int tamanho_pilha;
+
+    uint64_t semente;
+    uint64_t posicao;
+    TipoOperacao ultima_operacao;
+    Peca peca_jogada;
+} ModeloReferencia;
+
+static Peca novaPecaModelo(ModeloReferencia *modelo)
 {
-    if (ultima_operacao == OP_NENHUMA)
+    Peca peca;
+    peca.id = modelo->posicao + 1;
+    peca.nome[0] = TIPOS_PECA[tipoPecaNaPosicao(modelo->semente, 0, modelo->posicao)];
+    peca.nome[1] = '\0';
+    modelo->posicao++;
+    return peca;
+}
+
+static Peca removerFrenteModelo(ModeloReferencia *modelo)
+{
+    Peca frente = modelo->fila[0];
+    for (int i = 1; i < modelo->tamanho_fila; i++)
     {
-        printf("\n❌ Não há nenhuma operação recente (Jogar/Reservar) para desfazer.\n");
-        return;
+        modelo->fila[i - 1] = modelo->fila[i];
     }
+    modelo->tamanho_fila--;
+    return frente;
+}
 
-    printf("\n⏪ Desfazendo a última operação (%s)...\n",
-           ultima_operacao == OP_JOGAR ? "JOGAR" : "RESERVAR");
-
-    // 1. Desfaz o último ENQUEUE (remoção da peça nova gerada)
-    // A última peça inserida é sempre no índice anterior à traseira.
-    if (fila->tamanho > 0)
+static void inicializarModelo(ModeloReferencia *modelo, uint64_t semente)
+{
+    memset(modelo, 0, sizeof(*modelo));
+    modelo->semente = semente;
+    while (modelo->tamanho_fila < CAPACIDADE_FILA)
     {
-        fila->traseira = obterIndiceAnteriorTraseira(fila); // Volta a traseira
-        fila->tamanho--;                                    // Decrementa o tamanho
-        printf("   - [ID:%d|%s] (Nova Peça) removida da Traseira da Fila.\n", peca_historico_nova.id, peca_historico_nova.nome);
+        modelo->fila[modelo->tamanho_fila++] = novaPecaModelo(modelo);
     }
+}
+
+static ResultadoOperacao executarAcaoModelo(ModeloReferencia *modelo, Acao acao)
+{
+    switch (acao)
+    {
+    case ACAO_JOGAR:
+    case ACAO_RESERVAR:
+        if (acao == ACAO_RESERVAR && modelo->tamanho_pilha == CAPACIDADE_PILHA)
+        {
+            modelo->ultima_operacao = OP_NENHUMA;
+            return RESULTADO_PILHA_CHEIA;
+        }
+        if (modelo->tamanho_fila == 0)
+        {
+            modelo->ultima_operacao = OP_NENHUMA;
+            return RESULTADO_FILA_VAZIA;
+        }
+        modelo->peca_jogada = removerFrenteModelo(modelo);
+        if (acao == ACAO_RESERVAR)
+        {
+            modelo->pilha[modelo->tamanho_pilha++] = modelo->peca_jogada;
+        }
+        modelo->fila[modelo->tamanho_fila++] = novaPecaModelo(modelo);
+        modelo->ultima_operacao = acao == ACAO_JOGAR ? OP_JOGAR : OP_RESERVAR;
+        return RESULTADO_OK;
+
+    case ACAO_USAR:
+        if (modelo->tamanho_pilha == 0)
+        {
+            return RESULTADO_PILHA_VAZIA;
+        }
+        modelo->tamanho_pilha--;
+        modelo->ultima_operacao = OP_NENHUMA;
+        return RESULTADO_OK;
 
-    // 2. Reverte a peça jogada/reservada
-    if (ultima_operacao == OP_JOGAR)
+    case ACAO_TROCAR:
     {
-        // Reverte o Dequeue: A peça jogada volta para a frente
-        fila->frente = obterIndiceAnteriorFrente(fila); // Volta a frente
-        fila->tamanho++;                                // Incrementa o tamanho
-        fila->itens[fila->frente] = peca_historico_jogada;
-        printf("   - [ID:%d|%s] (Peça Jogada) restaurada na Frente da Fila.\n", peca_historico_jogada.id, peca_historico_jogada.nome);
+        if (modelo->tamanho_fila == 0)
+        {
+            return RESULTADO_FILA_VAZIA;
+        }
+        if (modelo->tamanho_pilha == 0)
+        {
+            return RESULTADO_PILHA_VAZIA;
+        }
+        Peca temp = modelo->fila[0];
+        modelo->fila[0] = modelo->pilha[modelo->tamanho_pilha - 1];
+        modelo->pilha[modelo->tamanho_pilha - 1] = temp;
+        modelo->ultima_operacao = OP_NENHUMA;
+        return RESULTADO_OK;
     }
-    else if (ultima_operacao == OP_RESERVAR)
+
+    case ACAO_DESFAZER:
+        if (modelo->ultima_operacao == OP_NENHUMA)
+        {
+            return RESULTADO_SEM_HISTORICO;
+        }
+        modelo->tamanho_fila--;
+        modelo->posicao--;
+        for (int i = modelo->tamanho_fila; i > 0; i--)
+        {
+            modelo->fila[i] = modelo->fila[i - 1];
+        }
+        modelo->fila[0] = modelo->peca_jogada;
+        modelo->tamanho_fila++;
+        if (modelo->ultima_operacao == OP_RESERVAR)
+        {
+            modelo->tamanho_pilha--;
+        }
+        modelo->ultima_operacao = OP_NENHUMA;
+        return RESULTADO_OK;
+
+    case ACAO_INVERTER:
     {
-        // Reverte o Dequeue da Fila: A peça reservada volta para a frente da Fila
-        fila->frente = obterIndiceAnteriorFrente(fila); // Volta a frente
-        fila->tamanho++;
-        fila->itens[fila->frente] = peca_historico_jogada;
-        printf("   - [ID:%d|%s] (Peça Reservada) restaurada na Frente da Fila.\n", peca_historico_jogada.id, peca_historico_jogada.nome);
+        ModeloReferencia antes = *modelo;
+        int para_pilha = antes.tamanho_fila < CAPACIDADE_PILHA ? antes.tamanho_fila : CAPACIDADE_PILHA;
 
-        // Reverte o PUSH na Pilha: A peça que entrou na pilha deve ser removida
-        if (pilha->topo > -1)
+        modelo->tamanho_pilha = 0;
+        for (int i = para_pilha - 1; i >= 0; i--)
+        {
+            modelo->pilha[modelo->tamanho_pilha++] = antes.fila[i];
+        }
+        modelo->tamanho_fila = 0;
+        for (int i = antes.tamanho_pilha - 1; i >= 0; i--)
+        {
+            modelo->fila[modelo->tamanho_fila++] = antes.pilha[i];
+        }
+        for (int i = para_pilha; i < antes.tamanho_fila; i++)
         {
-            pilha->topo--;
-            printf("   - A peça (PUSH) foi removida da Pilha de Reserva.\n");
+            modelo->fila[modelo->tamanho_fila++] = antes.fila[i];
         }
+        while (modelo->tamanho_fila < CAPACIDADE_FILA)
+        {
+            modelo->fila[modelo->tamanho_fila++] = novaPecaModelo(modelo);
+        }
+        modelo->ultima_operacao = OP_NENHUMA;
+        return RESULTADO_OK;
+    }
+
+    default:
+        return RESULTADO_OK;
     }
+}
 
-    // Resetar o histórico após o desfazer
-    ultima_operacao = OP_NENHUMA;
+static int pecasIguais(Peca a, Peca b)
+{
+    return a.id == b.id && a.nome[0] == b.nome[0];
 }
 
 /**
- * Inverte o conteúdo da Fila com o conteúdo da Pilha.
- * (A Fila vira Pilha e a Pilha vira Fila)
+ * Confere o motor contra o modelo e os invariantes: limites de tamanho, índices coerentes,
+ * ids únicos e conservação (peças na fila + pilha + consumidas == peças geradas).
+ * Retorna NULL se tudo estiver certo, ou a descrição do primeiro problema encontrado.
  */
-void inverterFilaComPilha(FilaCircular *fila, Pilha *pilha)
+static const char *verificarJogo(const Jogo *jogo, const ModeloReferencia *modelo, uint64_t consumidas)
 {
-    // 1. Cria Pilha temporária para Fila e Fila temporária para Pilha
-    Pilha temp_pilha;
-    inicializarPilha(&temp_pilha);
-    FilaCircular temp_fila;
-    inicializarFila(&temp_fila);
+    const FilaCircular *fila = &jogo->fila;
+    const Pilha *pilha = &jogo->pilha;
 
-    // 2. Fila atual -> Pilha temporária
-    // Desenfileira e empilha, invertendo a ordem original da fila
-    int original_fila_size = fila->tamanho;
-    for (int i = 0; i < original_fila_size; i++)
+    if (fila->tamanho < 0 || fila->tamanho > CAPACIDADE_FILA)
     {
-        Peca p = desenfileirar(fila);
-        empilhar(&temp_pilha, p);
+        return "tamanho da fila fora dos limites";
     }
-
-    // 3. Pilha atual -> Fila temporária
-    // Desempilha e enfileira, preservando a ordem original da pilha (LIFO)
-    int original_pilha_size = pilha->topo + 1;
-    for (int i = 0; i < original_pilha_size; i++)
+    if (pilha->topo < -1 || pilha->topo >= CAPACIDADE_PILHA)
     {
-        Peca p = desempilhar(pilha);
-        enfileirar(&temp_fila, p);
+        return "topo da pilha fora dos limites";
     }
-
-    // 4. Pilha temporária -> Fila original
-    // Desempilha e enfileira, invertendo a ordem da pilha temporária para manter a ordem da fila
-    for (int i = 0; i < original_fila_size; i++)
+    if ((fila->frente + fila->tamanho) % CAPACIDADE_FILA != fila->traseira)
     {
-        Peca p = desempilhar(&temp_pilha);
-        enfileirar(fila, p);
+        return "frente, traseira e tamanho da fila incoerentes";
     }
-
-    // 5. Fila temporária -> Pilha original
-    // Desenfileira e empilha, invertendo a ordem da fila temporária para voltar à pilha
-    for (int i = 0; i < original_pilha_size; i++)
+    if (fila->tamanho != modelo->tamanho_fila || pilha->topo + 1 != modelo->tamanho_pilha)
     {
-        Peca p = desenfileirar(&temp_fila);
-        empilhar(pilha, p);
+        return "tamanhos diferentes do modelo de referência";
+    }
+    if (jogo->gerador.posicao != modelo->posicao)
+    {
+        return "posição do gerador diferente do modelo de referência";
+    }
+    if ((uint64_t)(fila->tamanho + pilha->topo + 1) + consumidas != jogo->gerador.posicao)
+    {
+        return "conservação de peças violada";
     }
 
-    printf("\n🔁 Inversão Concluída: O conteúdo da Fila e da Pilha foram trocados.\n");
-
-    // Resetar histórico
-    ultima_operacao = OP_NENHUMA;
+    uint64_t ids[CAPACIDADE_FILA + CAPACIDADE_PILHA];
+    int total = 0;
+    for (int i = 0; i < fila->tamanho; i++)
+    {
+        Peca peca = fila->itens[(fila->frente + i) % CAPACIDADE_FILA];
+        if (!pecasIguais(peca, modelo->fila[i]))
+        {
+            return "conteúdo da fila diferente do modelo de referência";
+        }
+        ids[total++] = peca.id;
+    }
+    for (int i = 0; i <= pilha->topo; i++)
+    {
+        if (!pecasIguais(pilha->itens[i], modelo->pilha[i]))
+        {
+            return "conteúdo da pilha diferente do modelo de referência";
+        }
+        ids[total++] = pilha->itens[i].id;
+    }
+    for (int i = 0; i < total; i++)
+    {
+        if (ids[i] < 1 || ids[i] > jogo->gerador.posicao)
+        {
+            return "id de peça que nunca foi gerado";
+        }
+        for (int j = i + 1; j < total; j++)
+        {
+            if (ids[i] == ids[j])
+            {
+                return "id de peça duplicado";
+            }
+        }
+    }
+    return NULL;
 }
 
-// --- 7. Função Principal (main) e Menu de Execução ---
-
-int main()
+/**
+ * Executa a sequência de ações no motor e no modelo em paralelo.
+ * Retorna o índice da primeira ação que diverge (ou quebra um invariante), ou -1.
+ */
+static int executarSequenciaDiferencial(uint64_t semente, const uint8_t *acoes, int n, const char **erro)
 {
-    srand(time(NULL));
-
-    FilaCircular fila_futuras;
-    Pilha pilha_reserva;
-    int opcao;
+    Jogo jogo;
+    ModeloReferencia modelo;
+    uint64_t consumidas = 0;
 
-    // Inicialização
-    inicializarFila(&fila_futuras);
-    inicializarFilaAutomatica(&fila_futuras); // Fila cheia com 5 peças
-    inicializarPilha(&pilha_reserva);
+    inicializarJogo(&jogo, semente, 0);
+    inicializarModelo(&modelo, semente);
 
-    printf("👑 Bem-vindo ao Tetris Stack: Nível MESTRE! 👑\n");
-    printf("Sistema de Integração Total com Estratégia Inicializado.\n");
-    visualizarFila(&fila_futuras);
-    visualizarPilha(&pilha_reserva);
+    *erro = verificarJogo(&jogo, &modelo, consumidas);
+    if (*erro != NULL)
+    {
+        return 0;
+    }
 
-    do
+    for (int i = 0; i < n; i++)
     {
-        printf("\n--- 🧠 Menu Estratégico ---\n");
-        printf("\n1. Jogar a Próxima Peça (Dequeue + Novo Enqueue)\n");
-        printf("2. Reservar Peça (Dequeue da Fila -> PUSH na Pilha)\n");
-        printf("3. Usar Peça Reservada (POP da Pilha)\n");
-        printf("4. Trocar Peça (Topo da Pilha <-> Frente da Fila)\n");
-        printf("5. Desfazer Última Jogada/Reserva\n");
-        printf("6. Inverter Fila com Pilha\n");
-        printf("7. Visualizar Ambos\n");
-        printf("0. Sair do Programa\n");
-        printf("\nEscolha uma opção: ");
+        Acao acao = (Acao)acoes[i];
+        TipoOperacao desfeita = jogo.ultima_operacao;
 
-        if (scanf("%d", &opcao) != 1)
+        ResultadoOperacao resultado = executarAcao(&jogo, acao);
+        if (resultado != executarAcaoModelo(&modelo, acao))
         {
-            printf("🚫 Entrada inválida. Por favor, digite um número.\n");
-            while (getchar() != '\n')
-                ;
-            opcao = -1;
-            continue;
+            *erro = "resultado da operação diferente do modelo de referência";
+            return i;
         }
 
-        switch (opcao)
+        if (resultado == RESULTADO_OK)
         {
-        case 1:
-        { // Jogar (Dequeue e Novo Enqueue)
-            if (!filaVazia(&fila_futuras))
+            if (acao == ACAO_JOGAR || acao == ACAO_USAR)
             {
-                peca_historico_jogada = desenfileirar(&fila_futuras);
-                Peca nova_peca = gerarPeca();
-                enfileirar(&fila_futuras, nova_peca);
-                peca_historico_nova = nova_peca;
-
-                ultima_operacao = OP_JOGAR;
-                printf("\n🚀 Peça Jogada: [ID:%d|%s].\n", peca_historico_jogada.id, peca_historico_jogada.nome);
-                printf("➕ Nova Peça Inserida na Fila: [ID:%d|%s].\n", nova_peca.id, nova_peca.nome);
+                consumidas++;
             }
-            else
+            else if (acao == ACAO_DESFAZER && desfeita == OP_JOGAR)
             {
-                printf("\n❌ Fila vazia! Não é possível jogar.\n");
-                ultima_operacao = OP_NENHUMA;
+                consumidas--;
             }
-            break;
         }
-        case 2:
-        { // Reservar (Dequeue -> PUSH)
-            if (pilhaCheia(&pilha_reserva))
-            {
-                printf("\n❌ Pilha de Reserva cheia! Não é possível reservar mais peças.\n");
-                ultima_operacao = OP_NENHUMA;
-            }
-            else if (!filaVazia(&fila_futuras))
-            {
-                peca_historico_jogada = desenfileirar(&fila_futuras);
-                empilhar(&pilha_reserva, peca_historico_jogada);
 
-                Peca nova_peca = gerarPeca();
-                enfileirar(&fila_futuras, nova_peca);
-                peca_historico_nova = nova_peca;
-
-                ultima_operacao = OP_RESERVAR;
-                printf("\n📦 Peça Reservada: [ID:%d|%s] movida da Fila para a Pilha.\n", peca_historico_jogada.id, peca_historico_jogada.nome);
-                printf("➕ Nova Peça Inserida na Fila: [ID:%d|%s].\n", nova_peca.id, nova_peca.nome);
-            }
-            else
-            {
-                printf("\n❌ Fila vazia! Não há peças para reservar.\n");
-                ultima_operacao = OP_NENHUMA;
-            }
-            break;
+        *erro = verificarJogo(&jogo, &modelo, consumidas);
+        if (*erro != NULL)
+        {
+            return i;
         }
-        case 3:
-        { // Usar Peça Reservada (POP)
-            if (!pilhaVazia(&pilha_reserva))
+    }
+    return -1;
+}
+
+#define MAX_ACOES_SEQUENCIA 256
+
+/**
+ * Reduz uma sequência que falha removendo blocos cada vez menores enquanto a falha continuar.
+ * Retorna o novo tamanho da sequência.
+ */
+static int reduzirSequencia(uint64_t semente, uint8_t *acoes, int n)
+{
+    const char *erro;
+    int falha = executarSequenciaDiferencial(semente, acoes, n, &erro);
+    n = falha + 1; // Nada depois da ação que falhou é necessário
+
+    for (int bloco = n / 2; bloco >= 1; bloco /= 2)
+    {
+        for (int inicio = 0; inicio + bloco <= n;)
+        {
+            uint8_t candidata[MAX_ACOES_SEQUENCIA];
+            memcpy(candidata, acoes, inicio);
+            memcpy(candidata + inicio, acoes + inicio + bloco, n - inicio - bloco);
+
+            int falha_candidata = executarSequenciaDiferencial(semente, candidata, n - bloco, &erro);
+            if (falha_candidata >= 0)
             {
-                Peca peca_usada = desempilhar(&pilha_reserva);
-                printf("\n✅ Peça Reservada Usada: [ID:%d|%s] removida da Pilha (POP).\n", peca_usada.id, peca_usada.nome);
-                // Não gera nova peça nem salva histórico, pois é um uso estratégico.
-                ultima_operacao = OP_NENHUMA;
+                n = falha_candidata + 1;
+                memcpy(acoes, candidata, n);
             }
             else
             {
-                printf("\n❌ Pilha de Reserva vazia! Nenhuma peça para usar.\n");
+                inicio += bloco;
             }
-            break;
         }
-        case 4:
-        { // Trocar Peça (Topo da Pilha <-> Frente da Fila)
-            trocarPilhaFila(&fila_futuras, &pilha_reserva);
-            break;
+    }
+    return n;
+}
+
+/**
+ * Roda total_sequencias sequências aleatórias de ações (jogar, reservar, usar, trocar, desfazer
+ * e inverter) no motor e no modelo de referência. Na primeira divergência a sequência é reduzida
+ * e impressa como entrada para o menu, pronta para reproduzir o problema.
+ */
+int executarVerificacaoDiferencial(uint64_t semente, uint64_t total_sequencias, int tamanho_sequencia)
+{
+    if (tamanho_sequencia < 1 || tamanho_sequencia > MAX_ACOES_SEQUENCIA)
+    {
+        tamanho_sequencia = 64;
+    }
+
+    uint8_t acoes[MAX_ACOES_SEQUENCIA];
+    double inicio = tempoAgora();
+
+    for (uint64_t sequencia = 0; sequencia < total_sequencias; sequencia++)
+    {
+        uint64_t semente_sequencia = misturarBits(semente + sequencia);
+        for (int i = 0; i < tamanho_sequencia; i++)
+        {
+            acoes[i] = (uint8_t)(ACAO_JOGAR + misturarBits(semente_sequencia + i) % 6);
         }
-        case 5:
-        { // Desfazer Última Jogada
-            desfazerUltimaJogada(&fila_futuras, &pilha_reserva);
-            break;
+
+        const char *erro;
+        if (executarSequenciaDiferencial(semente_sequencia, acoes, tamanho_sequencia, &erro) < 0)
+        {
+            continue;
         }
-        case 6:
-        { // Inverter Fila com Pilha
-            inverterFilaComPilha(&fila_futuras, &pilha_reserva);
+
+        int n = reduzirSequencia(semente_sequencia, acoes, tamanho_sequencia);
+        executarSequenciaDiferencial(semente_sequencia, acoes, n, &erro);
+
+        printf("❌ Divergência na sequência %llu: %s\n", (unsigned long long)sequencia, erro);
+        printf("Sequência reduzida (%d ações). Para reproduzir:\n  printf '", n);
+        for (int i = 0; i < n; i++)
+        {
+            printf("%d\\n", acoes[i]);
+        }
+        printf("0\\n' | ./desafio-mestre --semente %llu\n", (unsigned long long)semente_sequencia);
+        return 1;
+    }
+
+    double duracao = tempoAgora() - inicio;
+    printf("✅ Verificação diferencial: %llu sequências de %d ações sem divergências.\n",
+           (unsigned long long)total_sequencias, tamanho_sequencia);
+    printf("Vazão: %.0f sequências/s | %.1f milhões de ações/s\n", total_sequencias / duracao,
+           total_sequencias * (double)tamanho_sequencia / duracao / 1e6);
+    return 0;
+}
+
+#ifdef TETRIS_FUZZ
+/**
+ * Alvo do libFuzzer (`make fuzz` compila o nível Mestre com -DTETRIS_FUZZ -fsanitize=fuzzer,address).
+ * Os 8 primeiros bytes são a semente; cada byte seguinte é uma ação.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *dados, size_t tamanho)
+{
+    if (tamanho < sizeof(uint64_t))
+    {
+        return 0;
+    }
+
+    uint64_t semente;
+    memcpy(&semente, dados, sizeof(semente));
+    dados += sizeof(semente);
+    tamanho -= sizeof(semente);
+
+    uint8_t acoes[MAX_ACOES_SEQUENCIA];
+    int n = tamanho < MAX_ACOES_SEQUENCIA ? (int)tamanho : MAX_ACOES_SEQUENCIA;
+    for (int i = 0; i < n; i++)
+    {
+        acoes[i] = (uint8_t)(ACAO_JOGAR + dados[i] % 6);
+    }
+
+    const char *erro;
+    if (executarSequenciaDiferencial(semente, acoes, n, &erro) >= 0)
+    {
+        fprintf(stderr, "Divergência: %s\n", erro);
+        abort();
+    }
+    return 0;
+}
+#endif
+
+// --- Benchmark da Janela de Prévia ---
+
+#define JOGADAS_POR_JANELA 16
+#define MAX_PROFUNDIDADE_PREVIA (1u << 24) // 256 MB de peças no buffer ansioso, bem abaixo de INT_MAX
+
+/**
+ * Compara a prévia ansiosa (um buffer com as D peças, gerado inteiro e reposto a cada
+ * jogada) com a JanelaPrevia preguiçosa, para consumidores que só jogam a peça da frente
+ * JOGADAS_POR_JANELA vezes. Confere também que as duas mostram as mesmas peças.
+ * main limita a profundidade a MAX_PROFUNDIDADE_PREVIA, então ela cabe no int de gerarPecasLote.
+ */
+int executarBenchmarkPrevia(uint64_t semente, uint64_t profundidade)
+{
+    uint64_t janelas = 50000000 / (profundidade + JOGADAS_POR_JANELA) + 1;
+    Peca *buffer = malloc(profundidade * sizeof(Peca));
+    if (buffer == NULL)
+    {
+        printf("❌ Memória insuficiente para uma prévia de %llu peças.\n", (unsigned long long)profundidade);
+        return 1;
+    }
+
+    // Prévia ansiosa: anel de D peças, todas geradas antes da primeira jogada
+    uint64_t soma_ansiosa = 0;
+    double inicio = tempoAgora();
+    for (uint64_t j = 0; j < janelas; j++)
+    {
+        GeradorPecas gerador;
+        inicializarGerador(&gerador, semente, j);
+        gerarPecasLote(&gerador, buffer, (int)profundidade);
+        uint64_t frente = 0;
+        for (int k = 0; k < JOGADAS_POR_JANELA; k++)
+        {
+            soma_ansiosa += (uint64_t)buffer[frente].nome[0];
+            buffer[frente] = gerarPeca(&gerador);
+            frente = (frente + 1) % profundidade;
+        }
+    }
+    double duracao_ansiosa = tempoAgora() - inicio;
+
+    // Prévia preguiçosa: nada é gerado até a peça ser retirada
+    uint64_t soma_preguicosa = 0;
+    inicio = tempoAgora();
+    for (uint64_t j = 0; j < janelas; j++)
+    {
+        JanelaPrevia janela;
+        inicializarJanelaPrevia(&janela, semente, j, profundidade);
+        for (int k = 0; k < JOGADAS_POR_JANELA; k++)
+        {
+            Peca peca;
+            retirarDaJanelaPrevia(&janela, &peca);
+            soma_preguicosa += (uint64_t)peca.nome[0];
+        }
+    }
+    double duracao_preguicosa = tempoAgora() - inicio;
+
+    // Conferência: depois das jogadas, a janela mostra as mesmas peças que o buffer ansioso
+    int divergencias = soma_ansiosa != soma_preguicosa;
+    for (uint64_t j = 0; j < 64 && !divergencias; j++)
+    {
+        GeradorPecas gerador;
+        JanelaPrevia janela;
+        Peca peca;
+        inicializarGerador(&gerador, semente, j);
+        gerarPecasLote(&gerador, buffer, (int)profundidade);
+        inicializarJanelaPrevia(&janela, semente, j, profundidade);
+        for (int k = 0; k < JOGADAS_POR_JANELA; k++)
+        {
+            buffer[k % profundidade] = gerarPeca(&gerador);
+            retirarDaJanelaPrevia(&janela, &peca);
+        }
+        for (uint64_t i = 0; i < profundidade; i++)
+        {
+            const Peca *esperada = &buffer[(JOGADAS_POR_JANELA + i) % profundidade];
+            if (!espiarJanelaPrevia(&janela, i, &peca) || !pecasIguais(peca, *esperada))
+            {
+                divergencias++;
+                break;
+            }
+        }
+    }
+    free(buffer);
+
+    printf("🔭 Prévia Ansiosa x Preguiçosa\n");
+    printf("Profundidade: %llu peças | Janelas: %llu | Jogadas por janela: %d\n", (unsigned long long)profundidade,
+           (unsigned long long)janelas, JOGADAS_POR_JANELA);
+    printf("---------------------------------------------------\n");
+    printf("Ansiosa:    %9.1f ns por janela | %zu bytes de peças\n", duracao_ansiosa / janelas * 1e9,
+           (size_t)profundidade * sizeof(Peca));
+    printf("Preguiçosa: %9.1f ns por janela | %zu bytes no total\n", duracao_preguicosa / janelas * 1e9,
+           sizeof(JanelaPrevia));
+    printf("Ganho: %.1fx\n", duracao_preguicosa > 0 ? duracao_ansiosa / duracao_preguicosa : 0.0);
+    printf("---------------------------------------------------\n");
+
+    if (divergencias > 0)
+    {
+        printf("❌ A janela preguiçosa mostrou peças diferentes da prévia ansiosa.\n");
+        return 1;
+    }
+    printf("✅ As duas prévias mostram exatamente as mesmas peças.\n");
+    return 0;
+}
+
+// --- Execução em Lote (muitas partidas simuladas em paralelo) ---
+
+#define JOGOS_POR_BLOCO 256
+
+/**
+ * @struct EstatisticasLote
+ * Contadores agregados de um conjunto de partidas simuladas.
+ */
+typedef struct
+{
+    uint64_t jogos;
+    uint64_t acoes;
+    uint64_t recusadas;
+    uint64_t pecas_jogadas;
+    uint64_t pecas_reservadas;
+    uint64_t pecas_usadas;
+    uint64_t trocas;
+    uint64_t desfeitas;
+    uint64_t inversoes;
+    uint64_t bloqueios_pilha_cheia;
+    uint64_t tentativas[ACAO_VISUALIZAR + 1]; // Quantas vezes cada opção do menu foi escolhida
+    uint64_t soma_ocupacao_pilha;             // Soma de (topo + 1) depois de cada ação
+    uint64_t maior_id;                        // Maior id de peça gerado em qualquer partida
+    uint64_t assinatura; // XOR do estado final de cada partida: igual para qualquer número de threads
+} EstatisticasLote;
+
+/**
+ * @struct TrabalhadorLote
+ * Estado de uma thread do lote. Cada trabalhador ocupa suas próprias linhas de cache,
+ * então as threads nunca disputam a mesma linha ao atualizar os contadores.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) EstatisticasLote estatisticas;
+    pthread_t thread;
+    int indice;
+    int cpu;
+    uint64_t semente;
+    uint64_t total_jogos;
+    int acoes_por_jogo;
+    uint64_t *proximo_bloco; // Contador compartilhado de blocos de jogos ainda não simulados
+    FILE *replays;           // Se não for NULL, cada partida é gravada como uma linha de replay
+    int falhou;              // 1 = a thread não conseguiu alocar suas sessões ou o buffer de replays
+} TrabalhadorLote;
+
+static void acumularResultado(EstatisticasLote *estatisticas, const Jogo *jogo, Acao acao, ResultadoOperacao resultado)
+{
+    estatisticas->acoes++;
+    estatisticas->tentativas[acao]++;
+    estatisticas->soma_ocupacao_pilha += jogo->pilha.topo + 1;
+    if (resultado != RESULTADO_OK)
+    {
+        estatisticas->recusadas++;
+        estatisticas->bloqueios_pilha_cheia += resultado == RESULTADO_PILHA_CHEIA;
+        return;
+    }
+
+    switch (acao)
+    {
+    case ACAO_JOGAR:
+        estatisticas->pecas_jogadas++;
+        break;
+    case ACAO_RESERVAR:
+        estatisticas->pecas_reservadas++;
+        break;
+    case ACAO_USAR:
+        estatisticas->pecas_usadas++;
+        break;
+    case ACAO_TROCAR:
+        estatisticas->trocas++;
+        break;
+    case ACAO_DESFAZER:
+        estatisticas->desfeitas++;
+        break;
+    case ACAO_INVERTER:
+        estatisticas->inversoes++;
+        break;
+    default:
+        break;
+    }
+}
+
+static uint64_t assinaturaJogo(const Jogo *jogo);
+
+// Fecha uma partida nas estatísticas: contagem, maior id e assinatura do estado final
+static void acumularFimDeJogo(EstatisticasLote *estatisticas, const Jogo *jogo)
+{
+    estatisticas->jogos++;
+    if (jogo->gerador.posicao > estatisticas->maior_id)
+    {
+        estatisticas->maior_id = jogo->gerador.posicao;
+    }
+    estatisticas->assinatura ^= assinaturaJogo(jogo);
+}
+
+void somarEstatisticas(EstatisticasLote *total, const EstatisticasLote *parcial)
+{
+    total->jogos += parcial->jogos;
+    total->acoes += parcial->acoes;
+    total->recusadas += parcial->recusadas;
+    total->pecas_jogadas += parcial->pecas_jogadas;
+    total->pecas_reservadas += parcial->pecas_reservadas;
+    total->pecas_usadas += parcial->pecas_usadas;
+    total->trocas += parcial->trocas;
+    total->desfeitas += parcial->desfeitas;
+    total->inversoes += parcial->inversoes;
+    total->bloqueios_pilha_cheia += parcial->bloqueios_pilha_cheia;
+    for (int i = 0; i <= ACAO_VISUALIZAR; i++)
+    {
+        total->tentativas[i] += parcial->tentativas[i];
+    }
+    total->soma_ocupacao_pilha += parcial->soma_ocupacao_pilha;
+    if (parcial->maior_id > total->maior_id)
+    {
+        total->maior_id = parcial->maior_id;
+    }
+    total->assinatura ^= parcial->assinatura;
+}
+
+// Resumo do estado final de uma partida, para conferir que o resultado não depende do paralelismo
+static uint64_t assinaturaJogo(const Jogo *jogo)
+{
+    uint64_t assinatura = misturarBits(jogo->gerador.chave ^ jogo->gerador.posicao);
+    for (int i = 0; i < jogo->fila.tamanho; i++)
+    {
+        assinatura = misturarBits(assinatura + jogo->fila.itens[(jogo->fila.frente + i) % CAPACIDADE_FILA].id);
+    }
+    for (int i = 0; i <= jogo->pilha.topo; i++)
+    {
+        assinatura = misturarBits(assinatura + (jogo->pilha.itens[i].id << 32));
+    }
+    return assinatura;
+}
+
+static void *executarTrabalhadorLote(void *argumento)
+{
+    TrabalhadorLote *trabalhador = argumento;
+
+    // Fixa a thread em um núcleo antes de tocar na memória das sessões
+    fixarThreadNoNucleo(trabalhador->cpu);
+
+    // As sessões são alocadas e zeradas pela própria thread já fixada: pela política de
+    // "primeiro toque" do kernel, as páginas ficam no nó NUMA local a este núcleo
+    PoolSessoes sessoes;
+    if (!criarPoolSessoes(&sessoes, JOGOS_POR_BLOCO))
+    {
+        trabalhador->falhou = 1;
+        return NULL;
+    }
+
+    // Replays de um bloco inteiro são montados aqui e gravados com um único fwrite
+    size_t capacidade_replays = trabalhador->replays ? JOGOS_POR_BLOCO * (size_t)(48 + trabalhador->acoes_por_jogo) : 0;
+    char *replays = trabalhador->replays ? malloc(capacidade_replays) : NULL;
+    if (trabalhador->replays != NULL && replays == NULL)
+    {
+        liberarPoolSessoes(&sessoes);
+        trabalhador->falhou = 1;
+        return NULL;
+    }
+
+    EstatisticasLote local = {0};
+    uint64_t total_blocos = (trabalhador->total_jogos + JOGOS_POR_BLOCO - 1) / JOGOS_POR_BLOCO;
+
+    for (;;)
+    {
+        uint64_t bloco = __atomic_fetch_add(trabalhador->proximo_bloco, 1, __ATOMIC_RELAXED);
+        if (bloco >= total_blocos)
+        {
+            break;
+        }
+
+        uint64_t primeiro = bloco * JOGOS_POR_BLOCO;
+        uint64_t ultimo = primeiro + JOGOS_POR_BLOCO;
+        if (ultimo > trabalhador->total_jogos)
+        {
+            ultimo = trabalhador->total_jogos;
+        }
+
+        size_t tamanho_replays = 0;
+        for (uint64_t numero = primeiro; numero < ultimo; numero++)
+        {
+            Jogo *jogo = obterSessao(&sessoes, (int)(numero - primeiro));
+            inicializarJogo(jogo, trabalhador->semente, numero);
+
+            if (replays != NULL)
+            {
+                tamanho_replays += sprintf(replays + tamanho_replays, "%llu %llu ",
+                                           (unsigned long long)trabalhador->semente, (unsigned long long)numero);
+            }
+
+            for (int passo = 0; passo < trabalhador->acoes_por_jogo; passo++)
+            {
+                Acao acao = (Acao)(ACAO_JOGAR + misturarBits(jogo->gerador.chave + passo) % 6);
+                acumularResultado(&local, jogo, acao, executarAcao(jogo, acao));
+                if (replays != NULL)
+                {
+                    replays[tamanho_replays++] = (char)('0' + acao);
+                }
+            }
+
+            if (replays != NULL)
+            {
+                replays[tamanho_replays++] = '\n';
+            }
+            acumularFimDeJogo(&local, jogo);
+        }
+
+        if (replays != NULL)
+        {
+            fwrite(replays, 1, tamanho_replays, trabalhador->replays);
+        }
+    }
+
+    free(replays);
+    liberarPoolSessoes(&sessoes);
+    trabalhador->estatisticas = local;
+    return NULL;
+}
+
+/**
+ * Simula total_jogos partidas independentes (o mesmo fluxo do menu, com ações sorteadas)
+ * em num_threads threads fixadas em núcleos. Os jogos são distribuídos em blocos por um
+ * contador atômico, cada thread acumula estatísticas só suas e a soma é feita no final.
+ */
+int executarLote(uint64_t semente, uint64_t total_jogos, int num_threads, int acoes_por_jogo, const char *arquivo_replays)
+{
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS)
+    {
+        num_threads = MAX_THREADS;
+    }
+    if (acoes_por_jogo < 1)
+    {
+        acoes_por_jogo = 64;
+    }
+
+    int num_cpus = contarNucleos();
+
+    TrabalhadorLote *trabalhadores = alocarTrabalhadores(num_threads, sizeof(TrabalhadorLote));
+    if (trabalhadores == NULL)
+    {
+        return 1;
+    }
+
+    FILE *replays = NULL;
+    if (arquivo_replays != NULL)
+    {
+        replays = fopen(arquivo_replays, "a");
+        if (replays == NULL)
+        {
+            perror(arquivo_replays);
+            free(trabalhadores);
+            return 1;
+        }
+    }
+
+    uint64_t proximo_bloco = 0;
+    double inicio = tempoAgora();
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        trabalhadores[i].indice = i;
+        trabalhadores[i].cpu = i % num_cpus;
+        trabalhadores[i].semente = semente;
+        trabalhadores[i].total_jogos = total_jogos;
+        trabalhadores[i].acoes_por_jogo = acoes_por_jogo;
+        trabalhadores[i].proximo_bloco = &proximo_bloco;
+        trabalhadores[i].replays = replays;
+    }
+    int rodou = RODAR_TRABALHADORES(trabalhadores, num_threads, executarTrabalhadorLote, NULL);
+
+    EstatisticasLote total = {0};
+    int falhas = 0;
+    for (int i = 0; i < num_threads; i++)
+    {
+        somarEstatisticas(&total, &trabalhadores[i].estatisticas);
+        falhas += trabalhadores[i].falhou;
+    }
+
+    double duracao = tempoAgora() - inicio;
+    free(trabalhadores);
+    if (replays != NULL)
+    {
+        fclose(replays);
+    }
+
+    if (!rodou)
+    {
+        return 1;
+    }
+    // As outras threads cobririam os blocos, mas o lote pedido não rodou como configurado
+    if (falhas > 0)
+    {
+        printf("❌ Memória insuficiente em %d de %d threads do lote.\n", falhas, num_threads);
+        return 1;
+    }
+
+    printf("🧮 Execução em Lote\n");
+    printf("Semente: %llu | Jogos: %llu | Ações por jogo: %d | Threads: %d (em %d núcleos)\n",
+           (unsigned long long)semente, (unsigned long long)total.jogos, acoes_por_jogo, num_threads, num_cpus);
+    printf("---------------------------------------------------\n");
+    printf("Peças jogadas: %llu | Reservadas: %llu | Usadas: %llu\n", (unsigned long long)total.pecas_jogadas,
+           (unsigned long long)total.pecas_reservadas, (unsigned long long)total.pecas_usadas);
+    printf("Trocas: %llu | Desfeitas: %llu | Inversões: %llu\n", (unsigned long long)total.trocas,
+           (unsigned long long)total.desfeitas, (unsigned long long)total.inversoes);
+    printf("Ações recusadas: %llu (pilha cheia: %llu)\n", (unsigned long long)total.recusadas,
+           (unsigned long long)total.bloqueios_pilha_cheia);
+    printf("Assinatura dos estados finais: %016llx\n", (unsigned long long)total.assinatura);
+    printf("---------------------------------------------------\n");
+    printf("Tempo: %.3f s | %.0f jogos/s | %.1f milhões de ações/s\n", duracao, total.jogos / duracao,
+           total.acoes / duracao / 1e6);
+    return 0;
+}
+
+// --- Maratona com Histórico Compacto ---
+
+#define PASSO_VERIFICACAO_HISTORICO 4096
+
+/**
+ * Joga uma partida longa gravando tudo no histórico compacto e depois desfaz a partida
+ * inteira, conferindo a cada PASSO_VERIFICACAO_HISTORICO níveis que o estado é o mesmo
+ * de quando aquele nível foi alcançado. Desfazer aparece também durante a partida, então
+ * a última visita a cada nível é a que está no caminho final.
+ */
+int executarMaratona(uint64_t semente, uint64_t numero_jogo, uint64_t total)
+{
+    static const Acao ACOES_MARATONA[8] = {ACAO_JOGAR, ACAO_JOGAR, ACAO_JOGAR, ACAO_RESERVAR,
+                                           ACAO_USAR, ACAO_TROCAR, ACAO_INVERTER, ACAO_DESFAZER};
+    Jogo jogo;
+    HistoricoCompacto historico;
+    uint64_t *assinaturas = malloc((total / PASSO_VERIFICACAO_HISTORICO + 1) * sizeof(uint64_t));
+
+    if (assinaturas == NULL || !criarHistorico(&historico, total + 64))
+    {
+        free(assinaturas);
+        printf("❌ Memória insuficiente para %llu operações.\n", (unsigned long long)total);
+        return 1;
+    }
+
+    inicializarJogo(&jogo, semente, numero_jogo);
+    assinaturas[0] = assinaturaJogo(&jogo);
+
+    double inicio = tempoAgora();
+    uint64_t maior_nivel = 0;
+    for (uint64_t i = 0; i < total; i++)
+    {
+        Acao acao = ACOES_MARATONA[misturarBits(jogo.gerador.chave + i) & 7];
+        if (executarAcaoComHistorico(&jogo, &historico, acao) == RESULTADO_OK &&
+            historico.operacoes % PASSO_VERIFICACAO_HISTORICO == 0)
+        {
+            assinaturas[historico.operacoes / PASSO_VERIFICACAO_HISTORICO] = assinaturaJogo(&jogo);
+        }
+        if (historico.operacoes > maior_nivel)
+        {
+            maior_nivel = historico.operacoes;
+        }
+    }
+    double duracao_jogo = tempoAgora() - inicio;
+
+    uint64_t registradas = historico.operacoes;
+    size_t bytes = historico.tamanho;
+    uint64_t divergencias = 0;
+
+    inicio = tempoAgora();
+    while (desfazerPeloHistorico(&jogo, &historico) == RESULTADO_OK)
+    {
+        if (historico.operacoes % PASSO_VERIFICACAO_HISTORICO == 0 &&
+            assinaturaJogo(&jogo) != assinaturas[historico.operacoes / PASSO_VERIFICACAO_HISTORICO])
+        {
+            divergencias++;
+        }
+    }
+    double duracao_desfazer = tempoAgora() - inicio;
+
+    printf("🏃 Maratona com Histórico Compacto\n");
+    printf("Semente: %llu | Jogo: %llu | Ações: %llu\n", (unsigned long long)semente,
+           (unsigned long long)numero_jogo, (unsigned long long)total);
+    printf("---------------------------------------------------\n");
+    printf("Operações no histórico: %llu (maior nível: %llu)\n", (unsigned long long)registradas,
+           (unsigned long long)maior_nivel);
+    printf("Histórico: %zu bytes | %.3f bytes por operação (cópias de Peca: %zu bytes por operação)\n",
+           bytes, registradas ? (double)bytes / registradas : 0.0, 2 * sizeof(Peca) + sizeof(TipoOperacao));
+    printf("Jogo: %.1f milhões de ações/s | Desfazer tudo: %.1f milhões de operações/s\n",
+           total / duracao_jogo / 1e6, registradas / duracao_desfazer / 1e6);
+    printf("---------------------------------------------------\n");
+
+    free(assinaturas);
+    liberarHistorico(&historico);
+
+    if (divergencias > 0 || jogo.gerador.posicao != CAPACIDADE_FILA)
+    {
+        printf("❌ %llu pontos de verificação divergiram ao desfazer a partida.\n", (unsigned long long)divergencias);
+        return 1;
+    }
+    printf("✅ Partida inteira desfeita até o estado inicial, sem divergências.\n");
+    return 0;
+}
+
+// --- Benchmark de Escalonamento das Sessões ---
+
+#define SESSOES_POR_THREAD 8
+
+/**
+ * @struct TrabalhadorEscalonamento
+ * Uma thread do benchmark. As sessões são intercaladas entre as threads (sessão i pertence à
+ * thread i % T), de modo que, na tabela compacta, vizinhas escritas por threads diferentes
+ * dividem linhas de cache; na tabela do pool cada sessão tem as suas próprias linhas.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) double duracao;
+    pthread_t thread;
+    int indice;
+    int cpu;
+    int num_threads;
+    uint64_t operacoes;
+    char *base;   // Primeira sessão da tabela
+    size_t passo; // Distância em bytes entre duas sessões consecutivas
+    LargadaTrabalhadores *largada;
+} TrabalhadorEscalonamento;
+
+static void *executarTrabalhadorEscalonamento(void *argumento)
+{
+    TrabalhadorEscalonamento *trabalhador = argumento;
+    fixarThreadNoNucleo(trabalhador->cpu);
+
+    Jogo *sessoes[SESSOES_POR_THREAD];
+    for (int s = 0; s < SESSOES_POR_THREAD; s++)
+    {
+        int indice = trabalhador->indice + s * trabalhador->num_threads;
+        sessoes[s] = (Jogo *)(trabalhador->base + indice * trabalhador->passo);
+    }
+
+    if (!aguardarLargada(trabalhador->largada))
+    {
+        return NULL;
+    }
+    double inicio = tempoAgora();
+
+    uint64_t chave = misturarBits((uint64_t)trabalhador->indice);
+    for (uint64_t k = 0; k < trabalhador->operacoes; k++)
+    {
+        Jogo *jogo = sessoes[k % SESSOES_POR_THREAD];
+        executarAcao(jogo, (Acao)(ACAO_JOGAR + misturarBits(chave + k) % 6));
+    }
+
+    trabalhador->duracao = tempoAgora() - inicio;
+    return NULL;
+}
+
+// Roda T threads sobre uma tabela de sessões e retorna milhões de operações por segundo (-1 se falhar)
+static double medirEscalonamento(char *base, size_t passo, int num_threads, uint64_t semente,
+                                 uint64_t operacoes_por_thread, int num_cpus)
+{
+    TrabalhadorEscalonamento *trabalhadores = alocarTrabalhadores(num_threads, sizeof(TrabalhadorEscalonamento));
+    if (trabalhadores == NULL)
+    {
+        return -1.0;
+    }
+
+    for (int i = 0; i < num_threads * SESSOES_POR_THREAD; i++)
+    {
+        inicializarJogo((Jogo *)(base + i * passo), semente, (uint64_t)i);
+    }
+
+    LargadaTrabalhadores largada;
+    for (int i = 0; i < num_threads; i++)
+    {
+        trabalhadores[i].indice = i;
+        trabalhadores[i].cpu = i % num_cpus;
+        trabalhadores[i].num_threads = num_threads;
+        trabalhadores[i].operacoes = operacoes_por_thread;
+        trabalhadores[i].base = base;
+        trabalhadores[i].passo = passo;
+        trabalhadores[i].largada = &largada;
+    }
+    if (!RODAR_TRABALHADORES(trabalhadores, num_threads, executarTrabalhadorEscalonamento, &largada))
+    {
+        free(trabalhadores);
+        return -1.0;
+    }
+
+    double maior_duracao = 0.0;
+    for (int i = 0; i < num_threads; i++)
+    {
+        if (trabalhadores[i].duracao > maior_duracao)
+        {
+            maior_duracao = trabalhadores[i].duracao;
+        }
+    }
+    free(trabalhadores);
+
+    return maior_duracao > 0.0 ? operacoes_por_thread * (double)num_threads / maior_duracao / 1e6 : 0.0;
+}
+
+/**
+ * Mede a vazão do motor de 1 até max_threads threads (dobrando a cada passo), comparando uma
+ * tabela compacta de Jogo com o pool de sessões alinhadas. A eficiência é a vazão com T
+ * threads dividida por T vezes a vazão com uma thread.
+ */
+int executarEscalonamento(uint64_t semente, uint64_t operacoes_por_thread, int max_threads)
+{
+    int num_cpus = contarNucleos();
+    if (max_threads < 1)
+    {
+        max_threads = num_cpus; // Sem --threads: até todos os núcleos
+    }
+    if (max_threads > MAX_THREADS)
+    {
+        max_threads = MAX_THREADS;
+    }
+
+    int total_sessoes = max_threads * SESSOES_POR_THREAD;
+    Jogo *compacta = malloc(total_sessoes * sizeof(Jogo));
+    PoolSessoes pool;
+    if (compacta == NULL || !criarPoolSessoes(&pool, total_sessoes))
+    {
+        free(compacta);
+        printf("❌ Memória insuficiente para %d sessões.\n", total_sessoes);
+        return 1;
+    }
+
+    printf("📈 Escalonamento das Sessões\n");
+    printf("Operações por thread: %llu | Sessões por thread: %d | Núcleos: %d\n",
+           (unsigned long long)operacoes_por_thread, SESSOES_POR_THREAD, num_cpus);
+    printf("Tamanho da sessão: compacta %zu bytes | alinhada %zu bytes\n", sizeof(Jogo), sizeof(SessaoJogo));
+    printf("---------------------------------------------------\n");
+    printf("Threads | Compacta (Mops/s) | Efic.  | Alinhada (Mops/s) | Efic.\n");
+
+    double base_compacta = 0.0, base_alinhada = 0.0;
+    for (int t = 1;; t = (t * 2 > max_threads && t < max_threads) ? max_threads : t * 2)
+    {
+        double vazao_compacta = medirEscalonamento((char *)compacta, sizeof(Jogo), t, semente,
+                                                   operacoes_por_thread, num_cpus);
+        double vazao_alinhada = medirEscalonamento((char *)pool.sessoes, sizeof(SessaoJogo), t, semente,
+                                                   operacoes_por_thread, num_cpus);
+        if (vazao_compacta < 0.0 || vazao_alinhada < 0.0)
+        {
+            free(compacta);
+            liberarPoolSessoes(&pool);
+            return 1;
+        }
+        if (t == 1)
+        {
+            base_compacta = vazao_compacta;
+            base_alinhada = vazao_alinhada;
+        }
+        printf("%7d | %17.1f | %5.1f%% | %17.1f | %5.1f%%\n", t,
+               vazao_compacta, base_compacta > 0.0 ? 100.0 * vazao_compacta / (t * base_compacta) : 0.0,
+               vazao_alinhada, base_alinhada > 0.0 ? 100.0 * vazao_alinhada / (t * base_alinhada) : 0.0);
+        if (t >= max_threads)
+        {
+            break;
+        }
+    }
+
+    free(compacta);
+    liberarPoolSessoes(&pool);
+    return 0;
+}
+
+// --- Fila MPMC e Sequência Compartilhada (modos cooperativo e versus) ---
+
+/*
+ * A FilaCircular tem um único dono. Para vários jogadores no mesmo processo há duas estruturas
+ * sem travas, ambas com células numeradas por sequência (no estilo de Dmitry Vyukov):
+ *  - FilaMPMC: fila limitada com vários produtores e consumidores; cada peça é entregue a
+ *    exatamente um consumidor (por exemplo, linhas de lixo trocadas entre jogadores).
+ *  - SequenciaCompartilhada: todos os jogadores leem a mesma sequência de peças, cada um com
+ *    seu próprio cursor, sem copiá-la; a célula só é reutilizada depois do último leitor.
+ */
+
+/**
+ * @struct CelulaMPMC
+ * A sequência diz o estado da célula: igual à posição = livre para escrita nessa volta;
+ * posição + 1 = contém uma peça pronta para leitura.
+ */
+typedef struct
+{
+    uint64_t sequencia;
+    Peca peca;
+} CelulaMPMC;
+
+/**
+ * @struct FilaMPMC
+ * As posições de escrita e leitura ficam em linhas de cache separadas, porque produtores e
+ * consumidores as disputam independentemente.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) uint64_t posicao_escrita;
+    _Alignas(TAMANHO_LINHA_CACHE) uint64_t posicao_leitura;
+    _Alignas(TAMANHO_LINHA_CACHE) CelulaMPMC *celulas;
+    uint64_t mascara; // capacidade - 1 (a capacidade é potência de 2)
+} FilaMPMC;
+
+int criarFilaMPMC(FilaMPMC *fila, uint64_t capacidade)
+{
+    if (capacidade < 2 || (capacidade & (capacidade - 1)) != 0)
+    {
+        return 0;
+    }
+    fila->celulas = aligned_alloc(TAMANHO_LINHA_CACHE, capacidade * sizeof(CelulaMPMC));
+    if (fila->celulas == NULL)
+    {
+        return 0;
+    }
+    for (uint64_t i = 0; i < capacidade; i++)
+    {
+        fila->celulas[i].sequencia = i;
+    }
+    fila->mascara = capacidade - 1;
+    fila->posicao_escrita = 0;
+    fila->posicao_leitura = 0;
+    return 1;
+}
+
+void liberarFilaMPMC(FilaMPMC *fila)
+{
+    free(fila->celulas);
+    fila->celulas = NULL;
+}
+
+// Retorna 0 se a fila estiver cheia
+int enfileirarMPMC(FilaMPMC *fila, Peca peca)
+{
+    uint64_t posicao = __atomic_load_n(&fila->posicao_escrita, __ATOMIC_RELAXED);
+    CelulaMPMC *celula;
+
+    for (;;)
+    {
+        celula = &fila->celulas[posicao & fila->mascara];
+        uint64_t sequencia = __atomic_load_n(&celula->sequencia, __ATOMIC_ACQUIRE);
+        int64_t diferenca = (int64_t)(sequencia - posicao);
+
+        if (diferenca == 0)
+        {
+            if (__atomic_compare_exchange_n(&fila->posicao_escrita, &posicao, posicao + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diferenca < 0)
+        {
+            return 0; // A célula ainda guarda uma peça da volta anterior
+        }
+        else
+        {
+            posicao = __atomic_load_n(&fila->posicao_escrita, __ATOMIC_RELAXED);
+        }
+    }
+
+    celula->peca = peca;
+    __atomic_store_n(&celula->sequencia, posicao + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Retorna 0 se a fila estiver vazia
+int desenfileirarMPMC(FilaMPMC *fila, Peca *destino)
+{
+    uint64_t posicao = __atomic_load_n(&fila->posicao_leitura, __ATOMIC_RELAXED);
+    CelulaMPMC *celula;
+
+    for (;;)
+    {
+        celula = &fila->celulas[posicao & fila->mascara];
+        uint64_t sequencia = __atomic_load_n(&celula->sequencia, __ATOMIC_ACQUIRE);
+        int64_t diferenca = (int64_t)(sequencia - (posicao + 1));
+
+        if (diferenca == 0)
+        {
+            if (__atomic_compare_exchange_n(&fila->posicao_leitura, &posicao, posicao + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diferenca < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            posicao = __atomic_load_n(&fila->posicao_leitura, __ATOMIC_RELAXED);
+        }
+    }
+
+    *destino = celula->peca;
+    __atomic_store_n(&celula->sequencia, posicao + fila->mascara + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * @struct CelulaSequencia
+ * Como na CelulaMPMC, mais o número de jogadores que ainda não leram a peça.
+ */
+typedef struct
+{
+    uint64_t sequencia;
+    uint32_t leitores_pendentes;
+    Peca peca;
+} CelulaSequencia;
+
+/**
+ * @struct SequenciaCompartilhada
+ * Anel de peças publicado por um ou mais produtores e lido por todos os jogadores. As peças
+ * vêm do gerador da partida (semente, jogo), então a peça k é a mesma de um jogo solo.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) uint64_t posicao_escrita;
+    _Alignas(TAMANHO_LINHA_CACHE) CelulaSequencia *celulas;
+    uint64_t mascara;
+    uint64_t chave;
+    uint32_t num_jogadores;
+} SequenciaCompartilhada;
+
+/**
+ * @struct CursorJogador
+ * Próxima posição que o jogador vai ler; cada cursor tem a sua linha de cache.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) uint64_t posicao;
+} CursorJogador;
+
+int criarSequenciaCompartilhada(SequenciaCompartilhada *sequencia, uint64_t capacidade, uint32_t num_jogadores,
+                                uint64_t semente, uint64_t numero_jogo)
+{
+    if (capacidade < 2 || (capacidade & (capacidade - 1)) != 0 || num_jogadores == 0)
+    {
+        return 0;
+    }
+    sequencia->celulas = aligned_alloc(TAMANHO_LINHA_CACHE, capacidade * sizeof(CelulaSequencia));
+    if (sequencia->celulas == NULL)
+    {
+        return 0;
+    }
+    for (uint64_t i = 0; i < capacidade; i++)
+    {
+        sequencia->celulas[i].sequencia = i;
+        sequencia->celulas[i].leitores_pendentes = 0;
+    }
+    sequencia->mascara = capacidade - 1;
+    sequencia->chave = chaveDoJogo(semente, numero_jogo);
+    sequencia->num_jogadores = num_jogadores;
+    sequencia->posicao_escrita = 0;
+    return 1;
+}
+
+void liberarSequenciaCompartilhada(SequenciaCompartilhada *sequencia)
+{
+    free(sequencia->celulas);
+    sequencia->celulas = NULL;
+}
+
+// Publica a próxima peça da sequência; retorna 0 se o jogador mais atrasado ainda não liberou a célula
+int publicarProximaPeca(SequenciaCompartilhada *sequencia)
+{
+    uint64_t posicao = __atomic_load_n(&sequencia->posicao_escrita, __ATOMIC_RELAXED);
+    CelulaSequencia *celula;
+
+    for (;;)
+    {
+        celula = &sequencia->celulas[posicao & sequencia->mascara];
+        uint64_t estado = __atomic_load_n(&celula->sequencia, __ATOMIC_ACQUIRE);
+        int64_t diferenca = (int64_t)(estado - posicao);
+
+        if (diferenca == 0)
+        {
+            if (__atomic_compare_exchange_n(&sequencia->posicao_escrita, &posicao, posicao + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diferenca < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            posicao = __atomic_load_n(&sequencia->posicao_escrita, __ATOMIC_RELAXED);
+        }
+    }
+
+    celula->peca.id = posicao + 1;
+    celula->peca.nome[0] = TIPOS_PECA[tipoPorChave(sequencia->chave, posicao)];
+    celula->peca.nome[1] = '\0';
+    celula->leitores_pendentes = sequencia->num_jogadores;
+    __atomic_store_n(&celula->sequencia, posicao + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Lê a peça na posição do cursor; retorna 0 se ela ainda não foi publicada
+int lerSequenciaCompartilhada(SequenciaCompartilhada *sequencia, CursorJogador *cursor, Peca *destino)
+{
+    uint64_t posicao = cursor->posicao;
+    CelulaSequencia *celula = &sequencia->celulas[posicao & sequencia->mascara];
+
+    if (__atomic_load_n(&celula->sequencia, __ATOMIC_ACQUIRE) != posicao + 1)
+    {
+        return 0;
+    }
+
+    *destino = celula->peca;
+    cursor->posicao = posicao + 1;
+
+    // O último leitor devolve a célula aos produtores para a próxima volta do anel
+    if (__atomic_fetch_sub(&celula->leitores_pendentes, 1, __ATOMIC_ACQ_REL) == 1)
+    {
+        __atomic_store_n(&celula->sequencia, posicao + sequencia->mascara + 1, __ATOMIC_RELEASE);
+    }
+    return 1;
+}
+
+// --- Benchmark de Contenção (FilaMPMC e SequenciaCompartilhada) ---
+
+#define CAPACIDADE_FILA_MPMC 1024
+#define CAPACIDADE_SEQUENCIA 256
+
+/**
+ * @struct TrabalhadorContencao
+ * Thread do benchmark: produtora ou consumidora da FilaMPMC, ou produtora ou jogadora da
+ * SequenciaCompartilhada. Os resultados ficam na primeira linha de cache da struct.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) uint64_t processadas;
+    uint64_t soma_ids;
+    uint64_t erros;
+    double inicio; // Instantes de largada e chegada desta thread
+    double fim;
+    pthread_t thread;
+    int produtor;
+    uint64_t quantidade; // Peças que esta thread produz ou consome
+    FilaMPMC *fila;
+    SequenciaCompartilhada *sequencia;
+    CursorJogador *cursor;
+    uint64_t semente;
+    LargadaTrabalhadores *largada;
+} TrabalhadorContencao;
+
+static void *executarTrabalhadorFilaMPMC(void *argumento)
+{
+    TrabalhadorContencao *trabalhador = argumento;
+    if (!aguardarLargada(trabalhador->largada))
+    {
+        return NULL;
+    }
+    trabalhador->inicio = tempoAgora();
+
+    uint64_t soma = 0;
+    for (uint64_t k = 0; k < trabalhador->quantidade; k++)
+    {
+        Peca peca = {(int)(k + 1), "I"};
+        if (trabalhador->produtor)
+        {
+            while (!enfileirarMPMC(trabalhador->fila, peca))
+            {
+                sched_yield();
+            }
+        }
+        else
+        {
+            while (!desenfileirarMPMC(trabalhador->fila, &peca))
+            {
+                sched_yield();
+            }
+        }
+        soma += (uint64_t)peca.id;
+    }
+
+    trabalhador->fim = tempoAgora();
+    trabalhador->processadas = trabalhador->quantidade;
+    trabalhador->soma_ids = soma;
+    return NULL;
+}
+
+static void *executarTrabalhadorSequencia(void *argumento)
+{
+    TrabalhadorContencao *trabalhador = argumento;
+    if (!aguardarLargada(trabalhador->largada))
+    {
+        return NULL;
+    }
+    trabalhador->inicio = tempoAgora();
+
+    uint64_t erros = 0;
+    if (trabalhador->produtor)
+    {
+        for (uint64_t k = 0; k < trabalhador->quantidade; k++)
+        {
+            while (!publicarProximaPeca(trabalhador->sequencia))
+            {
+                sched_yield();
+            }
+        }
+    }
+    else
+    {
+        // Cada jogador confere que vê exatamente a sequência de um jogo solo, na ordem
+        for (uint64_t k = 0; k < trabalhador->quantidade; k++)
+        {
+            Peca peca;
+            while (!lerSequenciaCompartilhada(trabalhador->sequencia, trabalhador->cursor, &peca))
+            {
+                sched_yield();
+            }
+            if (peca.id != k + 1 || peca.nome[0] != TIPOS_PECA[tipoPecaNaPosicao(trabalhador->semente, 0, k)])
+            {
+                erros++;
+            }
+        }
+    }
+
+    trabalhador->fim = tempoAgora();
+    trabalhador->processadas = trabalhador->quantidade;
+    trabalhador->erros = erros;
+    return NULL;
+}
+
+// Do primeiro início ao último fim entre as threads (a thread principal pode largar depois delas)
+static double duracaoContencao(const TrabalhadorContencao *trabalhadores, int n)
+{
+    double inicio = trabalhadores[0].inicio, fim = trabalhadores[0].fim;
+    for (int i = 1; i < n; i++)
+    {
+        inicio = trabalhadores[i].inicio < inicio ? trabalhadores[i].inicio : inicio;
+        fim = trabalhadores[i].fim > fim ? trabalhadores[i].fim : fim;
+    }
+    return fim - inicio;
+}
+
+/**
+ * Mede as duas estruturas com 2 a max_threads threads (dobrando a cada passo):
+ *  - FilaMPMC: metade produtores, metade consumidores, cada um com `pecas` peças;
+ *    a soma dos ids consumidos precisa bater com a dos produzidos.
+ *  - SequenciaCompartilhada: dois produtores e T - 2 jogadores (um e um com 2 threads), todos
+ *    lendo `pecas` peças; cada jogador confere id e tipo de cada peça.
+ */
+int executarContencao(uint64_t semente, uint64_t pecas, int max_threads)
+{
+    if (max_threads < 1)
+    {
+        max_threads = 64; // Sem --threads
+    }
+    if (max_threads < 2)
+    {
+        max_threads = 2; // Contenção precisa de pelo menos duas threads
+    }
+    if (max_threads > 64)
+    {
+        max_threads = 64;
+    }
+
+    TrabalhadorContencao *trabalhadores = alocarTrabalhadores(max_threads, sizeof(TrabalhadorContencao));
+    CursorJogador *cursores = alocarTrabalhadores(max_threads, sizeof(CursorJogador));
+    if (trabalhadores == NULL || cursores == NULL)
+    {
+        free(trabalhadores);
+        free(cursores);
+        return 1;
+    }
+    LargadaTrabalhadores largada;
+
+    printf("🤝 Benchmark de Contenção (FilaMPMC e Sequência Compartilhada)\n");
+    printf("Peças por thread: %llu | Núcleos: %d\n", (unsigned long long)pecas, contarNucleos());
+    printf("---------------------------------------------------\n");
+    printf("Threads | FilaMPMC (Mops/s) | Sequência: jogadores | leituras (Mops/s)\n");
+
+    int falhas = 0;
+    int abortada = 0;
+    for (int t = 2;; t = (t * 2 > max_threads && t < max_threads) ? max_threads : t * 2)
+    {
+        // FilaMPMC: produtores e consumidores em mesmo número
+        FilaMPMC fila;
+        if (!criarFilaMPMC(&fila, CAPACIDADE_FILA_MPMC))
+        {
+            printf("❌ Memória insuficiente para a FilaMPMC.\n");
+            abortada = 1;
+            break;
+        }
+        int pares = t / 2;
+        memset(trabalhadores, 0, t * sizeof(TrabalhadorContencao));
+        for (int i = 0; i < 2 * pares; i++)
+        {
+            trabalhadores[i].produtor = i < pares;
+            trabalhadores[i].quantidade = pecas;
+            trabalhadores[i].fila = &fila;
+            trabalhadores[i].largada = &largada;
+        }
+        if (!RODAR_TRABALHADORES(trabalhadores, 2 * pares, executarTrabalhadorFilaMPMC, &largada))
+        {
+            liberarFilaMPMC(&fila);
+            abortada = 1;
+            break;
+        }
+        uint64_t soma_produzida = 0, soma_consumida = 0;
+        for (int i = 0; i < 2 * pares; i++)
+        {
+            if (trabalhadores[i].produtor)
+            {
+                soma_produzida += trabalhadores[i].soma_ids;
+            }
+            else
+            {
+                soma_consumida += trabalhadores[i].soma_ids;
+            }
+        }
+        double duracao_fila = duracaoContencao(trabalhadores, 2 * pares);
+        liberarFilaMPMC(&fila);
+        if (soma_produzida != soma_consumida)
+        {
+            falhas++;
+        }
+
+        // SequenciaCompartilhada: produtores publicam, todos os jogadores leem tudo
+        int produtores = t > 2 ? 2 : 1;
+        int jogadores = t - produtores;
+        SequenciaCompartilhada sequencia;
+        if (!criarSequenciaCompartilhada(&sequencia, CAPACIDADE_SEQUENCIA, (uint32_t)jogadores, semente, 0))
+        {
+            printf("❌ Memória insuficiente para a sequência compartilhada.\n");
+            abortada = 1;
+            break;
+        }
+        memset(trabalhadores, 0, t * sizeof(TrabalhadorContencao));
+        memset(cursores, 0, t * sizeof(CursorJogador));
+        for (int i = 0; i < t; i++)
+        {
+            trabalhadores[i].produtor = i < produtores;
+            // As peças são divididas entre os produtores; a última leva o resto
+            trabalhadores[i].quantidade = trabalhadores[i].produtor
+                                              ? pecas / produtores + (i == produtores - 1 ? pecas % produtores : 0)
+                                              : pecas;
+            trabalhadores[i].sequencia = &sequencia;
+            trabalhadores[i].cursor = &cursores[i];
+            trabalhadores[i].semente = semente;
+            trabalhadores[i].largada = &largada;
+        }
+        if (!RODAR_TRABALHADORES(trabalhadores, t, executarTrabalhadorSequencia, &largada))
+        {
+            liberarSequenciaCompartilhada(&sequencia);
+            abortada = 1;
+            break;
+        }
+        for (int i = 0; i < t; i++)
+        {
+            falhas += trabalhadores[i].erros > 0;
+        }
+        double duracao_sequencia = duracaoContencao(trabalhadores, t);
+        liberarSequenciaCompartilhada(&sequencia);
+
+        printf("%7d | %17.2f | %20d | %17.2f\n", t, 2.0 * pares * pecas / duracao_fila / 1e6, jogadores,
+               (double)jogadores * pecas / duracao_sequencia / 1e6);
+
+        if (t >= max_threads)
+        {
+            break;
+        }
+    }
+
+    free(trabalhadores);
+    free(cursores);
+
+    printf("---------------------------------------------------\n");
+    if (abortada)
+    {
+        printf("❌ Benchmark interrompido: a rodada não pôde ser montada.\n");
+        return 1;
+    }
+    if (falhas > 0)
+    {
+        printf("❌ %d execuções perderam, duplicaram ou embaralharam peças.\n", falhas);
+        return 1;
+    }
+    printf("✅ Nenhuma peça perdida ou fora de ordem em nenhuma execução.\n");
+    return 0;
+}
+
+// --- Avaliação de Estratégias de Reserva (Monte Carlo) ---
+
+/*
+ * Modelo de resultado: a cada passo o tabuleiro pede um tipo de peça (uma sequência de
+ * demandas independente das peças geradas) e o jogador coloca exatamente uma peça, da frente
+ * da fila ou da reserva. O resultado de uma simulação é quantas peças colocadas atenderam à
+ * demanda. Todas as estratégias jogam as mesmas sequências de peças e demandas, então as
+ * diferenças entre elas são comparadas por simulação (intervalo de confiança pareado).
+ */
+
+#define MAX_PASSOS_ESTRATEGIA 1024
+#define NUM_ESTRATEGIAS 5
+#define SIMULACOES_POR_BLOCO 1024
+
+typedef enum
+{
+    RESERVA_LIFO, // Sai a última peça guardada (como a Pilha)
+    RESERVA_FIFO, // Sai a peça guardada há mais tempo
+    RESERVA_TROCA // Só troca a frente da fila com a peça guardada (como trocarPilhaFila)
+} DisciplinaReserva;
+
+typedef enum
+{
+    DECISAO_JOGAR,     // Coloca a frente da fila
+    DECISAO_USAR,      // Coloca a peça acessível da reserva
+    DECISAO_RESERVAR,  // Guarda a frente da fila e coloca a peça seguinte
+    DECISAO_TROCAR     // Guarda a frente da fila e coloca a peça que estava guardada
+} DecisaoReserva;
+
+/**
+ * @struct VisaoEstrategia
+ * Tudo o que uma política enxerga para decidir um passo.
+ */
+typedef struct
+{
+    char demanda;
+    const Peca *frente;    // Frente da fila
+    const Peca *proxima;   // Segunda peça da fila
+    const Peca *acessivel; // Peça que sairia da reserva (NULL se vazia)
+    int ocupacao;
+    int capacidade;
+} VisaoEstrategia;
+
+/**
+ * @struct EstrategiaReserva
+ * Uma estratégia é a forma da reserva (capacidade e disciplina) mais uma política de decisão.
+ * Novas estratégias entram só nesta tabela, sem mudar a fila, a pilha ou o simulador.
+ */
+typedef struct
+{
+    const char *nome;
+    int capacidade;
+    DisciplinaReserva disciplina;
+    DecisaoReserva (*decidir)(const VisaoEstrategia *visao);
+} EstrategiaReserva;
+
+static DecisaoReserva decidirSemReserva(const VisaoEstrategia *visao)
+{
+    (void)visao;
+    return DECISAO_JOGAR;
+}
+
+// Gulosa: atende a demanda com a frente, depois com a reserva, depois guardando a frente
+static DecisaoReserva decidirGulosa(const VisaoEstrategia *visao)
+{
+    if (visao->frente->nome[0] == visao->demanda)
+    {
+        return DECISAO_JOGAR;
+    }
+    if (visao->acessivel != NULL && visao->acessivel->nome[0] == visao->demanda)
+    {
+        return DECISAO_USAR;
+    }
+    if (visao->ocupacao < visao->capacidade && visao->proxima->nome[0] == visao->demanda)
+    {
+        return DECISAO_RESERVAR;
+    }
+    return DECISAO_JOGAR;
+}
+
+// Só troca: a peça guardada entra no lugar da frente, que passa a ser a guardada
+static DecisaoReserva decidirTroca(const VisaoEstrategia *visao)
+{
+    if (visao->frente->nome[0] == visao->demanda)
+    {
+        return DECISAO_JOGAR;
+    }
+    if (visao->acessivel != NULL ? visao->acessivel->nome[0] == visao->demanda
+                                 : visao->proxima->nome[0] == visao->demanda)
+    {
+        return DECISAO_TROCAR;
+    }
+    return DECISAO_JOGAR;
+}
+
+static const EstrategiaReserva ESTRATEGIAS[NUM_ESTRATEGIAS] = {
+    {"Pilha LIFO (3)", CAPACIDADE_PILHA, RESERVA_LIFO, decidirGulosa},
+    {"Reserva única (1)", 1, RESERVA_LIFO, decidirGulosa},
+    {"Reserva FIFO (3)", CAPACIDADE_PILHA, RESERVA_FIFO, decidirGulosa},
+    {"Só troca (1)", 1, RESERVA_TROCA, decidirTroca},
+    {"Sem reserva", 0, RESERVA_LIFO, decidirSemReserva},
+};
+
+/**
+ * @struct ReservaSimulada
+ * Reserva genérica das simulações: um pequeno anel que serve tanto de pilha quanto de fila,
+ * conforme a disciplina da estratégia.
+ */
+typedef struct
+{
+    Peca itens[CAPACIDADE_PILHA];
+    int inicio;
+    int tamanho;
+} ReservaSimulada;
+
+static const Peca *pecaAcessivel(const ReservaSimulada *reserva, DisciplinaReserva disciplina)
+{
+    if (reserva->tamanho == 0)
+    {
+        return NULL;
+    }
+    int indice = disciplina == RESERVA_FIFO ? reserva->inicio
+                                            : (reserva->inicio + reserva->tamanho - 1) % CAPACIDADE_PILHA;
+    return &reserva->itens[indice];
+}
+
+static Peca retirarDaReserva(ReservaSimulada *reserva, DisciplinaReserva disciplina)
+{
+    Peca peca = *pecaAcessivel(reserva, disciplina);
+    if (disciplina == RESERVA_FIFO)
+    {
+        reserva->inicio = (reserva->inicio + 1) % CAPACIDADE_PILHA;
+    }
+    reserva->tamanho--;
+    return peca;
+}
+
+static void guardarNaReserva(ReservaSimulada *reserva, Peca peca)
+{
+    reserva->itens[(reserva->inicio + reserva->tamanho) % CAPACIDADE_PILHA] = peca;
+    reserva->tamanho++;
+}
+
+// Retira a frente da fila e repõe a traseira com uma peça nova
+static Peca retirarFrenteReposta(FilaCircular *fila, GeradorPecas *gerador)
+{
+    Peca peca;
+    desenfileirar(fila, &peca);
+    enfileirar(fila, gerarPeca(gerador));
+    return peca;
+}
+
+// Joga uma simulação com a estratégia e retorna quantas peças atenderam à demanda
+static int simularEstrategia(const EstrategiaReserva *estrategia, uint64_t semente, uint64_t numero, int passos)
+{
+    FilaCircular fila;
+    GeradorPecas gerador;
+    ReservaSimulada reserva = {{{0, ""}}, 0, 0};
+    uint64_t chave_demanda = misturarBits(chaveDoJogo(semente, numero) ^ 0x5DEECE66DULL);
+    int acertos = 0;
+
+    inicializarGerador(&gerador, semente, numero);
+    inicializarFila(&fila);
+    inicializarFilaAutomatica(&fila, &gerador);
+
+    for (int passo = 0; passo < passos; passo++)
+    {
+        VisaoEstrategia visao;
+        visao.demanda = TIPOS_PECA[tipoPorChave(chave_demanda, (uint64_t)passo)];
+        visao.frente = espiarFila(&fila);
+        visao.proxima = &fila.itens[(fila.frente + 1) % CAPACIDADE_FILA];
+        visao.acessivel = pecaAcessivel(&reserva, estrategia->disciplina);
+        visao.ocupacao = reserva.tamanho;
+        visao.capacidade = estrategia->capacidade;
+
+        DecisaoReserva decisao = estrategia->decidir(&visao);
+        Peca colocada;
+
+        // Decisões impossíveis para a forma da reserva viram JOGAR
+        if (decisao == DECISAO_USAR && (visao.acessivel == NULL || estrategia->disciplina == RESERVA_TROCA))
+        {
+            decisao = DECISAO_JOGAR;
+        }
+        if (decisao == DECISAO_RESERVAR && reserva.tamanho >= estrategia->capacidade)
+        {
+            decisao = DECISAO_JOGAR;
+        }
+        if (decisao == DECISAO_TROCAR && estrategia->capacidade == 0)
+        {
+            decisao = DECISAO_JOGAR;
+        }
+
+        switch (decisao)
+        {
+        case DECISAO_USAR:
+            colocada = retirarDaReserva(&reserva, estrategia->disciplina);
+            break;
+        case DECISAO_RESERVAR:
+            guardarNaReserva(&reserva, retirarFrenteReposta(&fila, &gerador));
+            colocada = retirarFrenteReposta(&fila, &gerador);
+            break;
+        case DECISAO_TROCAR:
+            if (reserva.tamanho == 0)
+            {
+                // Primeira troca com a reserva vazia: guarda a frente e coloca a seguinte
+                guardarNaReserva(&reserva, retirarFrenteReposta(&fila, &gerador));
+                colocada = retirarFrenteReposta(&fila, &gerador);
+            }
+            else
+            {
+                colocada = retirarDaReserva(&reserva, estrategia->disciplina);
+                guardarNaReserva(&reserva, retirarFrenteReposta(&fila, &gerador));
+            }
+            break;
+        default:
+            colocada = retirarFrenteReposta(&fila, &gerador);
+            break;
+        }
+
+        acertos += colocada.nome[0] == visao.demanda;
+    }
+    return acertos;
+}
+
+/**
+ * @struct ResultadoEstrategia
+ * Acumuladores de uma estratégia: histograma de acertos por simulação e somas para a média,
+ * o desvio e a diferença pareada contra a primeira estratégia da tabela.
+ */
+typedef struct
+{
+    uint64_t histograma[MAX_PASSOS_ESTRATEGIA + 1];
+    double soma;
+    double soma_quadrados;
+    double soma_diferenca;
+    double soma_diferenca_quadrados;
+} ResultadoEstrategia;
+
+/**
+ * @struct TrabalhadorEstrategias
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) ResultadoEstrategia resultados[NUM_ESTRATEGIAS];
+    pthread_t thread;
+    int cpu;
+    int passos;
+    uint64_t semente;
+    uint64_t total;
+    uint64_t *proximo_bloco;
+} TrabalhadorEstrategias;
+
+static void *executarTrabalhadorEstrategias(void *argumento)
+{
+    TrabalhadorEstrategias *trabalhador = argumento;
+    fixarThreadNoNucleo(trabalhador->cpu);
+
+    uint64_t total_blocos = (trabalhador->total + SIMULACOES_POR_BLOCO - 1) / SIMULACOES_POR_BLOCO;
+    for (;;)
+    {
+        uint64_t bloco = __atomic_fetch_add(trabalhador->proximo_bloco, 1, __ATOMIC_RELAXED);
+        if (bloco >= total_blocos)
+        {
+            break;
+        }
+
+        uint64_t ultimo = (bloco + 1) * SIMULACOES_POR_BLOCO;
+        if (ultimo > trabalhador->total)
+        {
+            ultimo = trabalhador->total;
+        }
+
+        for (uint64_t numero = bloco * SIMULACOES_POR_BLOCO; numero < ultimo; numero++)
+        {
+            int referencia = 0;
+            for (int e = 0; e < NUM_ESTRATEGIAS; e++)
+            {
+                int acertos = simularEstrategia(&ESTRATEGIAS[e], trabalhador->semente, numero, trabalhador->passos);
+                ResultadoEstrategia *resultado = &trabalhador->resultados[e];
+                if (e == 0)
+                {
+                    referencia = acertos;
+                }
+                resultado->histograma[acertos]++;
+                resultado->soma += acertos;
+                resultado->soma_quadrados += (double)acertos * acertos;
+                resultado->soma_diferenca += acertos - referencia;
+                resultado->soma_diferenca_quadrados += (double)(acertos - referencia) * (acertos - referencia);
+            }
+        }
+    }
+    return NULL;
+}
+
+// Menor número de acertos que cobre a fração q das simulações
+static int percentilHistograma(const uint64_t *histograma, int passos, uint64_t total, double q)
+{
+    uint64_t acumulado = 0;
+    for (int i = 0; i <= passos; i++)
+    {
+        acumulado += histograma[i];
+        if (acumulado >= q * total)
+        {
+            return i;
+        }
+    }
+    return passos;
+}
+
+/**
+ * Roda `total` simulações de `passos` peças para cada estratégia, em paralelo, e imprime a
+ * taxa de acerto com intervalo de confiança de 95%, percentis da distribuição e a diferença
+ * pareada contra a Pilha LIFO de 3 posições.
+ */
+int executarAvaliacaoEstrategias(uint64_t semente, uint64_t total, int passos, int num_threads)
+{
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS)
+    {
+        num_threads = MAX_THREADS;
+    }
+    if (passos < 1 || passos > MAX_PASSOS_ESTRATEGIA)
+    {
+        passos = passos < 1 ? 64 : MAX_PASSOS_ESTRATEGIA;
+    }
+    if (total < 2)
+    {
+        total = 2;
+    }
+
+    int num_cpus = contarNucleos();
+    TrabalhadorEstrategias *trabalhadores = alocarTrabalhadores(num_threads, sizeof(TrabalhadorEstrategias));
+    ResultadoEstrategia *totais = calloc(NUM_ESTRATEGIAS, sizeof(ResultadoEstrategia));
+    if (trabalhadores == NULL || totais == NULL)
+    {
+        free(trabalhadores);
+        free(totais);
+        return 1;
+    }
+
+    uint64_t proximo_bloco = 0;
+    double inicio = tempoAgora();
+    for (int i = 0; i < num_threads; i++)
+    {
+        trabalhadores[i].cpu = i % num_cpus;
+        trabalhadores[i].passos = passos;
+        trabalhadores[i].semente = semente;
+        trabalhadores[i].total = total;
+        trabalhadores[i].proximo_bloco = &proximo_bloco;
+    }
+    if (!RODAR_TRABALHADORES(trabalhadores, num_threads, executarTrabalhadorEstrategias, NULL))
+    {
+        free(trabalhadores);
+        free(totais);
+        return 1;
+    }
+    for (int i = 0; i < num_threads; i++)
+    {
+        for (int e = 0; e < NUM_ESTRATEGIAS; e++)
+        {
+            const ResultadoEstrategia *parcial = &trabalhadores[i].resultados[e];
+            for (int a = 0; a <= passos; a++)
+            {
+                totais[e].histograma[a] += parcial->histograma[a];
+            }
+            totais[e].soma += parcial->soma;
+            totais[e].soma_quadrados += parcial->soma_quadrados;
+            totais[e].soma_diferenca += parcial->soma_diferenca;
+            totais[e].soma_diferenca_quadrados += parcial->soma_diferenca_quadrados;
+        }
+    }
+    double duracao = tempoAgora() - inicio;
+    free(trabalhadores);
+
+    printf("🎲 Avaliação de Estratégias de Reserva (Monte Carlo)\n");
+    printf("Semente: %llu | Simulações por estratégia: %llu | Peças por simulação: %d | Threads: %d\n",
+           (unsigned long long)semente, (unsigned long long)total, passos, num_threads);
+    printf("---------------------------------------------------\n");
+    printf("%-*s | Acerto médio (IC 95%%)  | p5  p50  p95 | vs %s (IC 95%%)\n", 18 + bytesExtrasUtf8("Estratégia"),
+           "Estratégia", ESTRATEGIAS[0].nome);
+
+    for (int e = 0; e < NUM_ESTRATEGIAS; e++)
+    {
+        const ResultadoEstrategia *r = &totais[e];
+        double n = (double)total;
+        double media = r->soma / n;
+        double variancia = (r->soma_quadrados - n * media * media) / (n - 1);
+        double margem = 1.96 * sqrt(variancia > 0 ? variancia / n : 0) / passos;
+        double media_diferenca = r->soma_diferenca / n;
+        double variancia_diferenca = (r->soma_diferenca_quadrados - n * media_diferenca * media_diferenca) / (n - 1);
+        double margem_diferenca = 1.96 * sqrt(variancia_diferenca > 0 ? variancia_diferenca / n : 0) / passos;
+
+        printf("%-*s | %6.2f%% ± %5.3f%%      | %3d %4d %4d | ", 18 + bytesExtrasUtf8(ESTRATEGIAS[e].nome), ESTRATEGIAS[e].nome,
+               100.0 * media / passos, 100.0 * margem,
+               percentilHistograma(r->histograma, passos, total, 0.05),
+               percentilHistograma(r->histograma, passos, total, 0.50),
+               percentilHistograma(r->histograma, passos, total, 0.95));
+        if (e == 0)
+        {
+            printf("referência\n");
+        }
+        else
+        {
+            printf("%+6.2f pp ± %5.3f pp\n", 100.0 * media_diferenca / passos, 100.0 * margem_diferenca);
+        }
+    }
+
+    printf("---------------------------------------------------\n");
+    printf("Tempo: %.3f s | %.0f simulações/s (todas as estratégias) | %.1f milhões de peças/s\n", duracao,
+           total * NUM_ESTRATEGIAS / duracao, (double)total * NUM_ESTRATEGIAS * passos / duracao / 1e6);
+    free(totais);
+    return 0;
+}
+
+// --- Versus: Tabuleiro Compacto, Linhas de Lixo e Duelo de Bots ---
+
+/*
+ * Cada jogador tem um tabuleiro de 10 colunas guardado como uma palavra de 16 bits por linha
+ * (bit c = coluna c, linha 0 = fundo), a sua própria partida (fila + pilha) e uma fila de
+ * lotes de lixo a receber. Limpar linhas gera ataque; o ataque primeiro cancela o lixo que o
+ * próprio jogador ainda tem a receber (lote mais antigo primeiro) e o que sobra vira um lote
+ * na fila do adversário. Um lote só sobe depois de ATRASO_LIXO peças do alvo, e só quando a
+ * peça travada não limpou linha nenhuma. Os dois jogadores recebem a mesma sequência de peças
+ * e tudo, inclusive a coluna do buraco de cada lote, sai da semente: cada duelo é reproduzível.
+ */
+
+#define LARGURA_TABULEIRO 10
+#define ALTURA_TABULEIRO 24 // 20 visíveis mais 4 de folga para a peça nascer
+#define ALTURA_VISIVEL 20
+#define LINHA_CHEIA 0x3FFu
+#define CAPACIDADE_LIXO 8
+#define ATRASO_LIXO 1
+#define MAX_LIXO_POR_PECA 8
+#define MAX_PECAS_VERSUS 500 // Peças por jogador antes de o duelo terminar empatado
+#define MAX_COMBO 11
+#define DUELOS_POR_BLOCO 64
+#define PENALIDADE_ESTOURO 1000000
+
+/**
+ * @struct Tabuleiro
+ */
+typedef struct
+{
+    uint16_t linhas[ALTURA_TABULEIRO];
+    int altura; // Linhas ocupadas a partir do fundo (tudo acima é vazio)
+} Tabuleiro;
+
+/**
+ * @struct FormaPeca
+ * Uma rotação de uma peça, da base para cima; bit c = coluna c a partir da esquerda da peça.
+ */
+typedef struct
+{
+    uint8_t linhas[4];
+    uint8_t largura;
+    uint8_t altura;
+} FormaPeca;
+
+typedef struct
+{
+    int num_rotacoes;
+    FormaPeca rotacoes[4];
+} RotacoesPeca;
+
+// Na mesma ordem de TIPOS_PECA (I, O, T, L, J, S, Z); rotações repetidas ficam de fora
+static const RotacoesPeca FORMAS_PECA[NUM_TIPOS_PECA] = {
+    {2, {{{0xF}, 4, 1}, {{1, 1, 1, 1}, 1, 4}}},
+    {1, {{{3, 3}, 2, 2}}},
+    {4, {{{7, 2}, 3, 2}, {{2, 7}, 3, 2}, {{1, 3, 1}, 2, 3}, {{2, 3, 2}, 2, 3}}},
+    {4, {{{7, 4}, 3, 2}, {{3, 1, 1}, 2, 3}, {{1, 7}, 3, 2}, {{2, 2, 3}, 2, 3}}},
+    {4, {{{7, 1}, 3, 2}, {{3, 2, 2}, 2, 3}, {{4, 7}, 3, 2}, {{1, 1, 3}, 2, 3}}},
+    {2, {{{3, 6}, 3, 2}, {{2, 3, 1}, 2, 3}}},
+    {2, {{{6, 3}, 3, 2}, {{1, 3, 2}, 2, 3}}},
+};
+
+// Linhas de ataque por número de linhas limpas de uma vez, mais o bônus por peças seguidas limpando
+static const int ATAQUE_POR_LINHAS[5] = {0, 0, 1, 2, 4};
+static const int ATAQUE_POR_COMBO[MAX_COMBO + 1] = {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 4, 5};
+
+/**
+ * @struct PerfilBot
+ * Pesos da avaliação de um tabuleiro. Cada bot do duelo é só uma linha de PERFIS_VERSUS.
+ */
+typedef struct
+{
+    const char *nome;
+    int peso_altura;         // Por linha somada sobre todas as colunas
+    int peso_buracos;        // Por célula vazia coberta
+    int peso_irregularidade; // Por diferença de altura entre colunas vizinhas
+    int bonus_linhas[5];     // Pelo número de linhas limpas na jogada
+} PerfilBot;
+
+static const PerfilBot PERFIS_VERSUS[2] = {
+    // Guarda as linhas para limpar 3 ou 4 de uma vez e mandar mais lixo
+    {"Ofensivo", 3, 40, 2, {0, -30, 5, 60, 160}},
+    // Limpa assim que pode e mantém o tabuleiro baixo
+    {"Defensivo", 6, 40, 3, {0, 20, 45, 70, 100}},
+};
+
+/**
+ * @struct LoteLixo
+ * Linhas de lixo enviadas de uma vez, todas com o buraco na mesma coluna.
+ */
+typedef struct
+{
+    int linhas;
+    int buraco;
+    uint32_t chegada; // Quantidade de peças do alvo a partir da qual o lote pode subir
+} LoteLixo;
+
+/**
+ * @struct FilaLixo
+ * Fila circular de lotes a receber, no mesmo formato da FilaCircular de peças.
+ */
+typedef struct
+{
+    int frente;
+    int tamanho;
+    LoteLixo itens[CAPACIDADE_LIXO];
+} FilaLixo;
+
+/**
+ * @struct JogadorVersus
+ */
+typedef struct
+{
+    Jogo jogo;
+    Tabuleiro tabuleiro;
+    FilaLixo lixo;
+    const PerfilBot *perfil;
+    uint32_t pecas;
+    int combo; // Peças seguidas que limparam pelo menos uma linha
+    int perdeu;
+} JogadorVersus;
+
+/**
+ * @struct EstatisticasJogadorVersus
+ */
+typedef struct
+{
+    uint64_t vitorias;
+    uint64_t pecas;
+    uint64_t linhas_limpas;
+    uint64_t linhas_enviadas;   // Ataque que chegou à fila do adversário
+    uint64_t linhas_canceladas; // Ataque gasto cancelando lixo que estava para subir
+    uint64_t lixo_recebido;     // Linhas de lixo que de fato subiram no tabuleiro
+    uint64_t usos_reserva;      // Peças jogadas a partir do topo da pilha
+    uint64_t reservas;          // Peças guardadas para jogar a seguinte
+} EstatisticasJogadorVersus;
+
+typedef struct
+{
+    EstatisticasJogadorVersus jogadores[2];
+    uint64_t duelos;
+    uint64_t empates;
+    uint64_t assinatura; // XOR do resumo de cada duelo: igual para qualquer número de threads
+} EstatisticasVersus;
+
+/**
+ * @struct JogadaVersus
+ * Melhor posição encontrada para uma peça (pontuacao INT32_MIN se não houver nenhuma).
+ */
+typedef struct
+{
+    int pontuacao;
+    const FormaPeca *forma;
+    int coluna;
+} JogadaVersus;
+
+static inline int colideForma(const Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, int linha)
+{
+    for (int r = 0; r < forma->altura; r++)
+    {
+        if (tabuleiro->linhas[linha + r] & (forma->linhas[r] << coluna))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Solta a forma na coluna dada, trava e limpa as linhas completas.
+ * Retorna as linhas limpas, ou -1 se a forma não cabe nem acima de tudo.
+ */
+static int soltarForma(Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna)
+{
+    int linha = tabuleiro->altura;
+    if (linha + forma->altura > ALTURA_TABULEIRO)
+    {
+        return -1;
+    }
+    while (linha > 0 && !colideForma(tabuleiro, forma, coluna, linha - 1))
+    {
+        linha--;
+    }
+
+    for (int r = 0; r < forma->altura; r++)
+    {
+        tabuleiro->linhas[linha + r] |= (uint16_t)(forma->linhas[r] << coluna);
+    }
+    if (linha + forma->altura > tabuleiro->altura)
+    {
+        tabuleiro->altura = linha + forma->altura;
+    }
+
+    // Só as linhas tocadas pela peça podem ter ficado completas
+    int limpas = 0;
+    int destino = linha;
+    for (int r = linha; r < tabuleiro->altura; r++)
+    {
+        if (tabuleiro->linhas[r] == LINHA_CHEIA)
+        {
+            limpas++;
+        }
+        else
+        {
+            tabuleiro->linhas[destino++] = tabuleiro->linhas[r];
+        }
+    }
+    for (int r = destino; r < tabuleiro->altura; r++)
+    {
+        tabuleiro->linhas[r] = 0;
+    }
+    tabuleiro->altura -= limpas;
+    return limpas;
+}
+
+/**
+ * Alturas das colunas e buracos (células vazias com algo acima). Percorre as linhas de cima
+ * para baixo acumulando a máscara das colunas já cobertas: os buracos de uma linha são as
+ * células vazias sob essa máscara, e a altura de uma coluna é a linha em que ela entra nela.
+ */
+static int analisarTabuleiro(const Tabuleiro *tabuleiro, int alturas[LARGURA_TABULEIRO])
+{
+    unsigned cobertura = 0;
+    int buracos = 0;
+
+    memset(alturas, 0, LARGURA_TABULEIRO * sizeof(int));
+    for (int r = tabuleiro->altura - 1; r >= 0; r--)
+    {
+        unsigned linha = tabuleiro->linhas[r];
+        buracos += __builtin_popcount(~linha & cobertura & LINHA_CHEIA);
+        for (unsigned novas = linha & ~cobertura; novas != 0; novas &= novas - 1)
+        {
+            alturas[__builtin_ctz(novas)] = r + 1;
+        }
+        cobertura |= linha;
+    }
+    return buracos;
+}
+
+static int pontuarTabuleiro(const int alturas[LARGURA_TABULEIRO], int buracos, int altura, int linhas_limpas,
+                            const PerfilBot *perfil)
+{
+    int soma_alturas = alturas[0];
+    int irregularidade = 0;
+    for (int c = 1; c < LARGURA_TABULEIRO; c++)
+    {
+        soma_alturas += alturas[c];
+        irregularidade += abs(alturas[c] - alturas[c - 1]);
+    }
+
+    int pontuacao = perfil->bonus_linhas[linhas_limpas] - perfil->peso_altura * soma_alturas -
+                    perfil->peso_buracos * buracos - perfil->peso_irregularidade * irregularidade;
+    if (altura > ALTURA_VISIVEL)
+    {
+        pontuacao -= PENALIDADE_ESTOURO;
+    }
+    return pontuacao;
+}
+
+/**
+ * Testa todas as rotações e colunas da peça. O pouso vem direto das alturas das colunas e,
+ * quando a peça não completa nenhuma linha, a pontuação é atualizada só nas colunas que ela
+ * ocupa; o tabuleiro só é copiado e reanalisado quando há linhas para limpar.
+ */
+static JogadaVersus melhorJogada(const Tabuleiro *tabuleiro, Peca peca, const PerfilBot *perfil)
+{
+    JogadaVersus melhor = {INT32_MIN, NULL, 0};
+    const RotacoesPeca *rotacoes = &FORMAS_PECA[indiceTipoPeca(peca)];
+    int alturas[LARGURA_TABULEIRO];
+    int buracos = analisarTabuleiro(tabuleiro, alturas);
+
+    for (int r = 0; r < rotacoes->num_rotacoes; r++)
+    {
+        const FormaPeca *forma = &rotacoes->rotacoes[r];
+
+        // Primeira e última linha ocupadas de cada coluna da forma
+        int fundo[4], topo[4];
+        for (int c = 0; c < forma->largura; c++)
+        {
+            fundo[c] = -1;
+            for (int l = 0; l < forma->altura; l++)
+            {
+                if (forma->linhas[l] & (1 << c))
+                {
+                    fundo[c] = fundo[c] < 0 ? l : fundo[c];
+                    topo[c] = l + 1;
+                }
+            }
+        }
+
+        for (int coluna = 0; coluna + forma->largura <= LARGURA_TABULEIRO; coluna++)
+        {
+            int linha = 0;
+            for (int c = 0; c < forma->largura; c++)
+            {
+                if (alturas[coluna + c] - fundo[c] > linha)
+                {
+                    linha = alturas[coluna + c] - fundo[c];
+                }
+            }
+            if (linha + forma->altura > ALTURA_TABULEIRO)
+            {
+                continue;
+            }
+
+            int completa = 0;
+            for (int l = 0; l < forma->altura; l++)
+            {
+                completa |= (tabuleiro->linhas[linha + l] | (forma->linhas[l] << coluna)) == LINHA_CHEIA;
+            }
+
+            int pontuacao;
+            if (completa)
+            {
+                Tabuleiro copia = *tabuleiro;
+                int limpas = soltarForma(&copia, forma, coluna);
+                int alturas_copia[LARGURA_TABULEIRO];
+                int buracos_copia = analisarTabuleiro(&copia, alturas_copia);
+                pontuacao = pontuarTabuleiro(alturas_copia, buracos_copia, copia.altura, limpas, perfil);
+            }
+            else
+            {
+                int alturas_depois[LARGURA_TABULEIRO];
+                int buracos_depois = buracos;
+                memcpy(alturas_depois, alturas, sizeof(alturas));
+                for (int c = 0; c < forma->largura; c++)
+                {
+                    buracos_depois += linha + fundo[c] - alturas[coluna + c];
+                    alturas_depois[coluna + c] = linha + topo[c];
+                }
+                int altura = linha + forma->altura > tabuleiro->altura ? linha + forma->altura : tabuleiro->altura;
+                pontuacao = pontuarTabuleiro(alturas_depois, buracos_depois, altura, 0, perfil);
+            }
+
+            if (pontuacao > melhor.pontuacao)
+            {
+                melhor.pontuacao = pontuacao;
+                melhor.forma = forma;
+                melhor.coluna = coluna;
+            }
+        }
+    }
+    return melhor;
+}
+
+// Acrescenta um lote; com a fila cheia, as linhas se juntam ao último lote
+static void enfileirarLixo(FilaLixo *fila, LoteLixo lote)
+{
+    if (fila->tamanho == CAPACIDADE_LIXO)
+    {
+        fila->itens[(fila->frente + fila->tamanho - 1) % CAPACIDADE_LIXO].linhas += lote.linhas;
+        return;
+    }
+    fila->itens[(fila->frente + fila->tamanho) % CAPACIDADE_LIXO] = lote;
+    fila->tamanho++;
+}
+
+// Gasta o ataque cancelando lotes pendentes, do mais antigo ao mais novo; retorna o que sobrou
+static int cancelarLixo(FilaLixo *fila, int ataque)
+{
+    while (ataque > 0 && fila->tamanho > 0)
+    {
+        LoteLixo *lote = &fila->itens[fila->frente];
+        int cancelado = ataque < lote->linhas ? ataque : lote->linhas;
+        lote->linhas -= cancelado;
+        ataque -= cancelado;
+        if (lote->linhas == 0)
+        {
+            fila->frente = (fila->frente + 1) % CAPACIDADE_LIXO;
+            fila->tamanho--;
+        }
+    }
+    return ataque;
+}
+
+// Empurra o tabuleiro n linhas para cima e põe n linhas de lixo no fundo. Retorna 0 se estourou.
+static int inserirLixo(Tabuleiro *tabuleiro, int n, int buraco)
+{
+    if (tabuleiro->altura + n > ALTURA_TABULEIRO)
+    {
+        return 0;
+    }
+    memmove(&tabuleiro->linhas[n], &tabuleiro->linhas[0], tabuleiro->altura * sizeof(uint16_t));
+    for (int r = 0; r < n; r++)
+    {
+        tabuleiro->linhas[r] = (uint16_t)(LINHA_CHEIA & ~(1u << buraco));
+    }
+    tabuleiro->altura += n;
+    return 1;
+}
+
+// Sobe os lotes que já chegaram, até MAX_LIXO_POR_PECA linhas; um lote pode subir em partes
+static int subirLixo(JogadorVersus *jogador)
+{
+    FilaLixo *fila = &jogador->lixo;
+    int subiram = 0;
+
+    while (fila->tamanho > 0 && subiram < MAX_LIXO_POR_PECA)
+    {
+        LoteLixo *lote = &fila->itens[fila->frente];
+        if (lote->chegada > jogador->pecas)
+        {
+            break;
+        }
+        int n = lote->linhas < MAX_LIXO_POR_PECA - subiram ? lote->linhas : MAX_LIXO_POR_PECA - subiram;
+        if (!inserirLixo(&jogador->tabuleiro, n, lote->buraco))
+        {
+            jogador->perdeu = 1;
+            return subiram;
+        }
+        subiram += n;
+        lote->linhas -= n;
+        if (lote->linhas == 0)
+        {
+            fila->frente = (fila->frente + 1) % CAPACIDADE_LIXO;
+            fila->tamanho--;
+        }
+    }
+    return subiram;
+}
+
+/**
+ * Uma peça do jogador: o bot compara jogar a frente da fila, jogar o topo da pilha e guardar
+ * a frente para jogar a peça seguinte, executa a melhor opção no motor e resolve ataque e lixo.
+ */
+static void jogarTurnoVersus(JogadorVersus *jogador, JogadorVersus *adversario, uint64_t chave_lixo,
+                             uint64_t *lotes_enviados, EstatisticasJogadorVersus *estatisticas)
+{
+    Jogo *jogo = &jogador->jogo;
+    JogadaVersus escolhida = melhorJogada(&jogador->tabuleiro, espiarPreviaJogo(jogo, 0), jogador->perfil);
+    Acao acao = ACAO_JOGAR;
+
+    if (!pilhaVazia(&jogo->pilha))
+    {
+        JogadaVersus reservada = melhorJogada(&jogador->tabuleiro, *espiarPilha(&jogo->pilha), jogador->perfil);
+        if (reservada.pontuacao > escolhida.pontuacao)
+        {
+            escolhida = reservada;
+            acao = ACAO_USAR;
+        }
+    }
+    if (!pilhaCheia(&jogo->pilha))
+    {
+        JogadaVersus seguinte = melhorJogada(&jogador->tabuleiro, espiarPreviaJogo(jogo, 1), jogador->perfil);
+        if (seguinte.pontuacao > escolhida.pontuacao)
+        {
+            escolhida = seguinte;
+            acao = ACAO_RESERVAR;
+        }
+    }
+
+    if (escolhida.forma == NULL)
+    {
+        jogador->perdeu = 1; // Nenhuma peça cabe mais
+        return;
+    }
+
+    Peca peca_usada;
+    switch (acao)
+    {
+    case ACAO_USAR:
+        usarPecaReservada(jogo, &peca_usada);
+        estatisticas->usos_reserva++;
+        break;
+    case ACAO_RESERVAR:
+        reservarPeca(jogo);
+        jogarPeca(jogo);
+        estatisticas->reservas++;
+        break;
+    default:
+        jogarPeca(jogo);
+        break;
+    }
+
+    int limpas = soltarForma(&jogador->tabuleiro, escolhida.forma, escolhida.coluna);
+    jogador->pecas++;
+    estatisticas->pecas++;
+    estatisticas->linhas_limpas += limpas;
+
+    jogador->combo = limpas > 0 ? jogador->combo + 1 : 0;
+    int ataque = ATAQUE_POR_LINHAS[limpas] + ATAQUE_POR_COMBO[jogador->combo < MAX_COMBO ? jogador->combo : MAX_COMBO];
+    int restante = cancelarLixo(&jogador->lixo, ataque);
+    estatisticas->linhas_canceladas += ataque - restante;
+    if (restante > 0)
+    {
+        uint64_t sorteio = misturarBits(chave_lixo + (*lotes_enviados)++ * 0x9E3779B97F4A7C15ULL);
+        LoteLixo lote = {restante, (int)(((sorteio >> 32) * LARGURA_TABULEIRO) >> 32), adversario->pecas + ATRASO_LIXO};
+        enfileirarLixo(&adversario->lixo, lote);
+        estatisticas->linhas_enviadas += restante;
+    }
+    else if (limpas == 0)
+    {
+        estatisticas->lixo_recebido += subirLixo(jogador);
+    }
+
+    if (jogador->tabuleiro.altura > ALTURA_VISIVEL)
+    {
+        jogador->perdeu = 1;
+    }
+}
+
+/**
+ * Um duelo completo entre os dois perfis. Quem começa alterna com o número do duelo.
+ * Retorna o índice do vencedor, ou -1 em caso de empate.
+ */
+static int executarDuelo(uint64_t semente, uint64_t numero, EstatisticasVersus *estatisticas)
+{
+    JogadorVersus jogadores[2];
+    for (int p = 0; p < 2; p++)
+    {
+        inicializarJogo(&jogadores[p].jogo, semente, numero);
+        memset(&jogadores[p].tabuleiro, 0, sizeof(Tabuleiro));
+        memset(&jogadores[p].lixo, 0, sizeof(FilaLixo));
+        jogadores[p].perfil = &PERFIS_VERSUS[p];
+        jogadores[p].pecas = 0;
+        jogadores[p].combo = 0;
+        jogadores[p].perdeu = 0;
+    }
+
+    uint64_t chave_lixo = chaveDoJogo(semente ^ 0x4C49584FULL, numero); // "LIXO": outra sequência
+    uint64_t lotes_enviados = 0;
+    int primeiro = (int)(numero & 1);
+    int vencedor = -1;
+
+    for (int turno = 0; turno < MAX_PECAS_VERSUS && vencedor < 0; turno++)
+    {
+        for (int ordem = 0; ordem < 2; ordem++)
+        {
+            int p = primeiro ^ ordem;
+            jogarTurnoVersus(&jogadores[p], &jogadores[1 - p], chave_lixo, &lotes_enviados, &estatisticas->jogadores[p]);
+            if (jogadores[p].perdeu)
+            {
+                vencedor = 1 - p;
+                break;
+            }
+        }
+    }
+
+    estatisticas->duelos++;
+    if (vencedor < 0)
+    {
+        estatisticas->empates++;
+    }
+    else
+    {
+        estatisticas->jogadores[vencedor].vitorias++;
+    }
+    estatisticas->assinatura ^= misturarBits(numero ^ ((uint64_t)jogadores[0].pecas << 24) ^
+                                             ((uint64_t)jogadores[1].pecas << 44) ^ (uint64_t)(vencedor + 1));
+    return vencedor;
+}
+
+/**
+ * @struct TrabalhadorVersus
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) EstatisticasVersus estatisticas;
+    pthread_t thread;
+    int cpu;
+    uint64_t semente;
+    uint64_t total;
+    uint64_t *proximo_bloco;
+} TrabalhadorVersus;
+
+static void *executarTrabalhadorVersus(void *argumento)
+{
+    TrabalhadorVersus *trabalhador = argumento;
+    fixarThreadNoNucleo(trabalhador->cpu);
+
+    uint64_t total_blocos = (trabalhador->total + DUELOS_POR_BLOCO - 1) / DUELOS_POR_BLOCO;
+    for (;;)
+    {
+        uint64_t bloco = __atomic_fetch_add(trabalhador->proximo_bloco, 1, __ATOMIC_RELAXED);
+        if (bloco >= total_blocos)
+        {
+            break;
+        }
+
+        uint64_t ultimo = (bloco + 1) * DUELOS_POR_BLOCO;
+        if (ultimo > trabalhador->total)
+        {
+            ultimo = trabalhador->total;
+        }
+        for (uint64_t numero = bloco * DUELOS_POR_BLOCO; numero < ultimo; numero++)
+        {
+            executarDuelo(trabalhador->semente, numero, &trabalhador->estatisticas);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Roda `total` duelos entre os perfis de PERFIS_VERSUS em paralelo e imprime vitórias,
+ * ataque, cancelamento e lixo recebido de cada bot, além da vazão em duelos por segundo.
+ */
+int executarVersus(uint64_t semente, uint64_t total, int num_threads)
+{
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS)
+    {
+        num_threads = MAX_THREADS;
+    }
+
+    int num_cpus = contarNucleos();
+    TrabalhadorVersus *trabalhadores = alocarTrabalhadores(num_threads, sizeof(TrabalhadorVersus));
+    if (trabalhadores == NULL)
+    {
+        return 1;
+    }
+
+    uint64_t proximo_bloco = 0;
+    double inicio = tempoAgora();
+    for (int i = 0; i < num_threads; i++)
+    {
+        trabalhadores[i].cpu = i % num_cpus;
+        trabalhadores[i].semente = semente;
+        trabalhadores[i].total = total;
+        trabalhadores[i].proximo_bloco = &proximo_bloco;
+    }
+    if (!RODAR_TRABALHADORES(trabalhadores, num_threads, executarTrabalhadorVersus, NULL))
+    {
+        free(trabalhadores);
+        return 1;
+    }
+
+    EstatisticasVersus totais;
+    memset(&totais, 0, sizeof(totais));
+    for (int i = 0; i < num_threads; i++)
+    {
+        const EstatisticasVersus *parcial = &trabalhadores[i].estatisticas;
+        totais.duelos += parcial->duelos;
+        totais.empates += parcial->empates;
+        totais.assinatura ^= parcial->assinatura;
+        for (int p = 0; p < 2; p++)
+        {
+            EstatisticasJogadorVersus *destino = &totais.jogadores[p];
+            const EstatisticasJogadorVersus *origem = &parcial->jogadores[p];
+            destino->vitorias += origem->vitorias;
+            destino->pecas += origem->pecas;
+            destino->linhas_limpas += origem->linhas_limpas;
+            destino->linhas_enviadas += origem->linhas_enviadas;
+            destino->linhas_canceladas += origem->linhas_canceladas;
+            destino->lixo_recebido += origem->lixo_recebido;
+            destino->usos_reserva += origem->usos_reserva;
+            destino->reservas += origem->reservas;
+        }
+    }
+    double duracao = tempoAgora() - inicio;
+    free(trabalhadores);
+
+    double duelos = totais.duelos > 0 ? (double)totais.duelos : 1.0;
+    printf("⚔️  Versus: %s x %s\n", PERFIS_VERSUS[0].nome, PERFIS_VERSUS[1].nome);
+    printf("Semente: %llu | Duelos: %llu | Threads: %d | Limite: %d peças por jogador\n", (unsigned long long)semente,
+           (unsigned long long)totais.duelos, num_threads, MAX_PECAS_VERSUS);
+    printf("---------------------------------------------------\n");
+    printf("%-10s | Vitórias | Peças/duelo | Linhas/duelo | Enviadas | Canceladas | Lixo recebido | Pilha (usar/guardar)\n",
+           "Bot");
+    for (int p = 0; p < 2; p++)
+    {
+        const EstatisticasJogadorVersus *j = &totais.jogadores[p];
+        printf("%-10s | %7.2f%% | %11.1f | %12.1f | %8.1f | %10.1f | %13.1f | %.1f / %.1f\n", PERFIS_VERSUS[p].nome,
+               100.0 * j->vitorias / duelos, j->pecas / duelos, j->linhas_limpas / duelos, j->linhas_enviadas / duelos,
+               j->linhas_canceladas / duelos, j->lixo_recebido / duelos, j->usos_reserva / duelos, j->reservas / duelos);
+    }
+    printf("Empates: %.2f%%\n", 100.0 * totais.empates / duelos);
+    printf("---------------------------------------------------\n");
+    uint64_t pecas = totais.jogadores[0].pecas + totais.jogadores[1].pecas;
+    printf("Tempo: %.3f s | %.0f duelos/s (%.0f por thread) | %.2f milhões de peças/s\n", duracao, totais.duelos / duracao,
+           totais.duelos / duracao / num_threads, pecas / duracao / 1e6);
+    printf("Assinatura dos duelos: %016llx\n", (unsigned long long)totais.assinatura);
+    return 0;
+}
+
+// --- Filas Empacotadas (muitas candidatas por vetor, AVX2 com alternativa escalar) ---
+
+/*
+ * Um avaliador que compara futuros possíveis guarda dezenas de cópias pequenas da fila. Aqui
+ * elas ficam transpostas: posicoes[j] tem a peça j (0 = frente) de todas as 32 candidatas,
+ * um byte de tipo por candidata, e cada linha cabe num registrador de 256 bits. Assim,
+ * retirar a frente e repor, trocar com a reserva e contar um tipo valem para as 32 candidatas
+ * com algumas instruções, sem laço por candidata. Posições a partir do tamanho de cada fila
+ * guardam sempre TIPO_VAZIO, então as versões AVX2 e escalar produzem os mesmos bytes.
+ */
+
+#define CANDIDATAS_EMPACOTADAS 32
+#define POSICOES_EMPACOTADAS 8
+#define TIPO_VAZIO 0xFF
+#define RODADAS_POR_MEDICAO 4096
+
+/**
+ * @struct FilasEmpacotadas
+ */
+typedef struct
+{
+    _Alignas(32) uint8_t posicoes[POSICOES_EMPACOTADAS][CANDIDATAS_EMPACOTADAS];
+    _Alignas(32) uint8_t tamanhos[CANDIDATAS_EMPACOTADAS];
+    _Alignas(32) uint8_t reservas[CANDIDATAS_EMPACOTADAS]; // Tipo no topo da pilha (TIPO_VAZIO se vazia)
+} FilasEmpacotadas;
+
+/**
+ * @struct OperacoesEmpacotadas
+ * Implementação escolhida uma vez, em tempo de execução, conforme o processador.
+ */
+typedef struct
+{
+    const char *nome;
+    // Como jogarPeca em cada candidata: a frente sai e novas[c] entra no fim (filas vazias não mudam)
+    void (*retirarERepor)(FilasEmpacotadas *filas, const uint8_t *novas);
+    // Como trocarPilhaFila: troca a frente com a reserva onde há as duas
+    void (*trocarComReserva)(FilasEmpacotadas *filas);
+    // contagem[c] = quantas peças do tipo há na fila da candidata c
+    void (*contarTipo)(const FilasEmpacotadas *filas, uint8_t tipo, uint8_t *contagem);
+} OperacoesEmpacotadas;
+
+// A frente de todas as candidatas já está junta: é a primeira linha
+static inline const uint8_t *espiarFrentesEmpacotadas(const FilasEmpacotadas *filas)
+{
+    return filas->posicoes[0];
+}
+
+// Copia a fila e o topo da pilha de uma partida para a candidata c
+void empacotarCandidata(FilasEmpacotadas *filas, int c, const Jogo *jogo)
+{
+    const FilaCircular *fila = &jogo->fila;
+    for (int j = 0; j < POSICOES_EMPACOTADAS; j++)
+    {
+        filas->posicoes[j][c] = j < fila->tamanho
+                                    ? (uint8_t)indiceTipoPeca(fila->itens[(fila->frente + j) % CAPACIDADE_FILA])
+                                    : TIPO_VAZIO;
+    }
+    filas->tamanhos[c] = (uint8_t)fila->tamanho;
+    filas->reservas[c] = pilhaVazia(&jogo->pilha) ? TIPO_VAZIO : (uint8_t)indiceTipoPeca(*espiarPilha(&jogo->pilha));
+}
+
+static void retirarEReporEscalar(FilasEmpacotadas *filas, const uint8_t *novas)
+{
+    for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+    {
+        int tamanho = filas->tamanhos[c];
+        if (tamanho == 0)
+        {
+            continue;
+        }
+        for (int j = 0; j < tamanho - 1; j++)
+        {
+            filas->posicoes[j][c] = filas->posicoes[j + 1][c];
+        }
+        filas->posicoes[tamanho - 1][c] = novas[c];
+    }
+}
+
+static void trocarComReservaEscalar(FilasEmpacotadas *filas)
+{
+    for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+    {
+        if (filas->tamanhos[c] > 0 && filas->reservas[c] != TIPO_VAZIO)
+        {
+            uint8_t temp = filas->posicoes[0][c];
+            filas->posicoes[0][c] = filas->reservas[c];
+            filas->reservas[c] = temp;
+        }
+    }
+}
+
+static void contarTipoEscalar(const FilasEmpacotadas *filas, uint8_t tipo, uint8_t *contagem)
+{
+    for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+    {
+        uint8_t total = 0;
+        for (int j = 0; j < filas->tamanhos[c]; j++)
+        {
+            total += filas->posicoes[j][c] == tipo;
+        }
+        contagem[c] = total;
+    }
+}
+
+static const OperacoesEmpacotadas OPERACOES_ESCALARES = {"escalar", retirarEReporEscalar, trocarComReservaEscalar,
+                                                         contarTipoEscalar};
+
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Versões AVX2: compiladas com target("avx2") para que o resto do programa continue rodando
+ * em qualquer x86-64; só são chamadas se __builtin_cpu_supports("avx2") confirmar o suporte.
+ */
+__attribute__((target("avx2"))) static void retirarEReporAvx2(FilasEmpacotadas *filas, const uint8_t *novas)
+{
+    __m256i tamanhos = _mm256_load_si256((const __m256i *)filas->tamanhos);
+    __m256i nova = _mm256_loadu_si256((const __m256i *)novas);
+    __m256i ativas = _mm256_xor_si256(_mm256_cmpeq_epi8(tamanhos, _mm256_setzero_si256()), _mm256_set1_epi8(-1));
+    __m256i ultimas = _mm256_sub_epi8(tamanhos, _mm256_set1_epi8(1));
+
+    // Cada linha recebe a seguinte; a posição tamanho - 1 de cada candidata recebe a peça nova
+    __m256i atual = _mm256_load_si256((const __m256i *)filas->posicoes[0]);
+    for (int j = 0; j < POSICOES_EMPACOTADAS; j++)
+    {
+        __m256i seguinte = j + 1 < POSICOES_EMPACOTADAS ? _mm256_load_si256((const __m256i *)filas->posicoes[j + 1])
+                                                        : _mm256_set1_epi8((char)TIPO_VAZIO);
+        __m256i deslocada = _mm256_blendv_epi8(seguinte, nova, _mm256_cmpeq_epi8(ultimas, _mm256_set1_epi8((char)j)));
+        _mm256_store_si256((__m256i *)filas->posicoes[j], _mm256_blendv_epi8(atual, deslocada, ativas));
+        atual = seguinte;
+    }
+}
+
+__attribute__((target("avx2"))) static void trocarComReservaAvx2(FilasEmpacotadas *filas)
+{
+    __m256i frentes = _mm256_load_si256((const __m256i *)filas->posicoes[0]);
+    __m256i reservas = _mm256_load_si256((const __m256i *)filas->reservas);
+    __m256i tamanhos = _mm256_load_si256((const __m256i *)filas->tamanhos);
+    __m256i sem_troca = _mm256_or_si256(_mm256_cmpeq_epi8(reservas, _mm256_set1_epi8((char)TIPO_VAZIO)),
+                                        _mm256_cmpeq_epi8(tamanhos, _mm256_setzero_si256()));
+
+    _mm256_store_si256((__m256i *)filas->posicoes[0], _mm256_blendv_epi8(reservas, frentes, sem_troca));
+    _mm256_store_si256((__m256i *)filas->reservas, _mm256_blendv_epi8(frentes, reservas, sem_troca));
+}
+
+__attribute__((target("avx2"))) static void contarTipoAvx2(const FilasEmpacotadas *filas, uint8_t tipo,
+                                                           uint8_t *contagem)
+{
+    __m256i procurado = _mm256_set1_epi8((char)tipo);
+    __m256i total = _mm256_setzero_si256();
+    for (int j = 0; j < POSICOES_EMPACOTADAS; j++)
+    {
+        // cmpeq dá -1 onde o tipo bate: subtrair soma 1
+        __m256i linha = _mm256_load_si256((const __m256i *)filas->posicoes[j]);
+        total = _mm256_sub_epi8(total, _mm256_cmpeq_epi8(linha, procurado));
+    }
+    _mm256_storeu_si256((__m256i *)contagem, total);
+}
+
+static const OperacoesEmpacotadas OPERACOES_AVX2 = {"AVX2", retirarEReporAvx2, trocarComReservaAvx2, contarTipoAvx2};
+#endif
+
+const OperacoesEmpacotadas *escolherOperacoesEmpacotadas()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return &OPERACOES_AVX2;
+    }
+#endif
+    return &OPERACOES_ESCALARES;
+}
+
+// Contagem direta na FilaCircular da partida, para conferir as versões empacotadas
+static int contarTipoNaFila(const FilaCircular *fila, int tipo)
+{
+    int total = 0;
+    for (int j = 0; j < fila->tamanho; j++)
+    {
+        total += indiceTipoPeca(fila->itens[(fila->frente + j) % CAPACIDADE_FILA]) == tipo;
+    }
+    return total;
+}
+
+/**
+ * Confere as filas empacotadas contra o motor: 32 partidas de verdade recebem as mesmas
+ * operações (jogar, trocar, e reservar ou usar para mudar a pilha) e, a cada rodada, as
+ * versões escalar e vetorial precisam ser byte a byte iguais ao reempacotamento das partidas.
+ * Depois, estados sintéticos com tamanhos de 0 a 8 exercitam os casos que o motor não produz.
+ */
+static int verificarFilasEmpacotadas(const OperacoesEmpacotadas *vetorial, uint64_t semente, uint64_t rodadas)
+{
+    Jogo jogos[CANDIDATAS_EMPACOTADAS];
+    FilasEmpacotadas escalar, vetor, esperado;
+    uint8_t novas[CANDIDATAS_EMPACOTADAS];
+    uint8_t contagem_escalar[CANDIDATAS_EMPACOTADAS], contagem_vetor[CANDIDATAS_EMPACOTADAS];
+
+    memset(&escalar, TIPO_VAZIO, sizeof(escalar));
+    for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+    {
+        inicializarJogo(&jogos[c], semente, (uint64_t)c);
+        empacotarCandidata(&escalar, c, &jogos[c]);
+    }
+    vetor = escalar;
+
+    for (uint64_t r = 0; r < rodadas; r++)
+    {
+        uint64_t sorteio = misturarBits(semente ^ (r * 0x9E3779B97F4A7C15ULL));
+        switch (sorteio % 4)
+        {
+        case 0:
+        case 1:
+            for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+            {
+                jogarPeca(&jogos[c]);
+                novas[c] = (uint8_t)indiceTipoPeca(jogos[c].peca_historico_nova);
+            }
+            OPERACOES_ESCALARES.retirarERepor(&escalar, novas);
+            vetorial->retirarERepor(&vetor, novas);
+            break;
+        case 2:
+            for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+            {
+                trocarPilhaFila(&jogos[c]);
+            }
+            OPERACOES_ESCALARES.trocarComReserva(&escalar);
+            vetorial->trocarComReserva(&vetor);
+            break;
+        default:
+        {
+            // Reservar e usar mexem na pilha inteira, então a candidata é reempacotada
+            int c = (int)((sorteio >> 8) % CANDIDATAS_EMPACOTADAS);
+            Peca peca_usada;
+            if ((sorteio >> 16) & 1)
+            {
+                reservarPeca(&jogos[c]);
+            }
+            else
+            {
+                usarPecaReservada(&jogos[c], &peca_usada);
+            }
+            empacotarCandidata(&escalar, c, &jogos[c]);
+            empacotarCandidata(&vetor, c, &jogos[c]);
+            break;
+        }
+        }
+
+        memset(&esperado, TIPO_VAZIO, sizeof(esperado));
+        for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+        {
+            empacotarCandidata(&esperado, c, &jogos[c]);
+        }
+        if (memcmp(&escalar, &esperado, sizeof(esperado)) != 0 || memcmp(&vetor, &esperado, sizeof(esperado)) != 0)
+        {
+            printf("❌ Rodada %llu: filas empacotadas diferentes das partidas.\n", (unsigned long long)r);
+            return 0;
+        }
+
+        int tipo = (int)((sorteio >> 24) % NUM_TIPOS_PECA);
+        OPERACOES_ESCALARES.contarTipo(&escalar, (uint8_t)tipo, contagem_escalar);
+        vetorial->contarTipo(&vetor, (uint8_t)tipo, contagem_vetor);
+        for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+        {
+            int contagem = contarTipoNaFila(&jogos[c].fila, tipo);
+            if (contagem_escalar[c] != contagem || contagem_vetor[c] != contagem)
+            {
+                printf("❌ Rodada %llu: contagem do tipo %c na candidata %d.\n", (unsigned long long)r, TIPOS_PECA[tipo], c);
+                return 0;
+            }
+        }
+    }
+
+    for (uint64_t r = 0; r < rodadas; r++)
+    {
+        memset(&escalar, TIPO_VAZIO, sizeof(escalar));
+        for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+        {
+            uint64_t sorteio = misturarBits(semente + r * CANDIDATAS_EMPACOTADAS + (uint64_t)c);
+            escalar.tamanhos[c] = (uint8_t)(sorteio % (POSICOES_EMPACOTADAS + 1));
+            for (int j = 0; j < escalar.tamanhos[c]; j++)
+            {
+                escalar.posicoes[j][c] = (uint8_t)((sorteio >> (8 + 3 * j)) % NUM_TIPOS_PECA);
+            }
+            escalar.reservas[c] = (sorteio >> 40) % 4 == 0 ? TIPO_VAZIO : (uint8_t)((sorteio >> 48) % NUM_TIPOS_PECA);
+            novas[c] = (uint8_t)((sorteio >> 56) % NUM_TIPOS_PECA);
+        }
+        vetor = escalar;
+
+        OPERACOES_ESCALARES.retirarERepor(&escalar, novas);
+        vetorial->retirarERepor(&vetor, novas);
+        OPERACOES_ESCALARES.trocarComReserva(&escalar);
+        vetorial->trocarComReserva(&vetor);
+        OPERACOES_ESCALARES.contarTipo(&escalar, (uint8_t)(r % NUM_TIPOS_PECA), contagem_escalar);
+        vetorial->contarTipo(&vetor, (uint8_t)(r % NUM_TIPOS_PECA), contagem_vetor);
+        if (memcmp(&escalar, &vetor, sizeof(vetor)) != 0 ||
+            memcmp(contagem_escalar, contagem_vetor, sizeof(contagem_vetor)) != 0)
+        {
+            printf("❌ Estado sintético %llu: versões escalar e %s diferentes.\n", (unsigned long long)r, vetorial->nome);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Uma rodada do avaliador: todas as candidatas jogam, metade das rodadas troca, e os 7 tipos são contados
+static uint64_t medirRodadasEmpacotadas(const OperacoesEmpacotadas *operacoes, FilasEmpacotadas *filas,
+                                        const uint8_t (*novas)[CANDIDATAS_EMPACOTADAS], uint64_t rodadas)
+{
+    uint8_t contagem[CANDIDATAS_EMPACOTADAS];
+    uint64_t soma = 0;
+    for (uint64_t r = 0; r < rodadas; r++)
+    {
+        operacoes->retirarERepor(filas, novas[r % RODADAS_POR_MEDICAO]);
+        if (r & 1)
+        {
+            operacoes->trocarComReserva(filas);
+        }
+        for (int t = 0; t < NUM_TIPOS_PECA; t++)
+        {
+            operacoes->contarTipo(filas, (uint8_t)t, contagem);
+            soma += (uint64_t)contagem[(r + (uint64_t)t) % CANDIDATAS_EMPACOTADAS] * (uint64_t)(t + 1);
+        }
+    }
+    return soma;
+}
+
+// A mesma rodada com o laço por candidata sobre as partidas (FilaCircular + Pilha)
+static uint64_t medirRodadasPartidas(Jogo *jogos, uint64_t rodadas)
+{
+    uint64_t soma = 0;
+    for (uint64_t r = 0; r < rodadas; r++)
+    {
+        for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+        {
+            jogarPeca(&jogos[c]);
+            if (r & 1)
+            {
+                trocarPilhaFila(&jogos[c]);
+            }
+        }
+        for (int t = 0; t < NUM_TIPOS_PECA; t++)
+        {
+            soma += contarTipoNaFila(&jogos[r % CANDIDATAS_EMPACOTADAS].fila, t);
+            for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+            {
+                soma += (uint64_t)contarTipoNaFila(&jogos[c].fila, t) << 32;
+            }
+        }
+    }
+    return soma;
+}
+
+/**
+ * Verifica as filas empacotadas contra o motor e mede `rodadas` rodadas de 32 candidatas
+ * com o laço por partida, com a versão escalar empacotada e com a versão escolhida pelo
+ * processador (AVX2 quando houver).
+ */
+int executarFilasEmpacotadas(uint64_t semente, uint64_t rodadas)
+{
+    const OperacoesEmpacotadas *escolhidas = escolherOperacoesEmpacotadas();
+    uint64_t rodadas_verificacao = rodadas < 100000 ? rodadas : 100000;
+
+    printf("🧮 Filas Empacotadas (%d candidatas x %d posições)\n", CANDIDATAS_EMPACOTADAS, POSICOES_EMPACOTADAS);
+    printf("Semente: %llu | Rodadas: %llu | Implementação escolhida: %s\n", (unsigned long long)semente,
+           (unsigned long long)rodadas, escolhidas->nome);
+    printf("---------------------------------------------------\n");
+
+    if (!verificarFilasEmpacotadas(escolhidas, semente, rodadas_verificacao))
+    {
+        return 1;
+    }
+    printf("✅ Escalar e %s iguais às partidas em %llu rodadas e em %llu estados sintéticos.\n", escolhidas->nome,
+           (unsigned long long)rodadas_verificacao, (unsigned long long)rodadas_verificacao);
+
+    Jogo *jogos = malloc(CANDIDATAS_EMPACOTADAS * sizeof(Jogo));
+    uint8_t(*novas)[CANDIDATAS_EMPACOTADAS] = aligned_alloc(32, RODADAS_POR_MEDICAO * CANDIDATAS_EMPACOTADAS);
+    if (jogos == NULL || novas == NULL)
+    {
+        free(jogos);
+        free(novas);
+        return 1;
+    }
+
+    FilasEmpacotadas iniciais;
+    memset(&iniciais, TIPO_VAZIO, sizeof(iniciais));
+    for (int c = 0; c < CANDIDATAS_EMPACOTADAS; c++)
+    {
+        inicializarJogo(&jogos[c], semente, (uint64_t)c);
+        reservarPeca(&jogos[c]);
+        empacotarCandidata(&iniciais, c, &jogos[c]);
+        for (int r = 0; r < RODADAS_POR_MEDICAO; r++)
+        {
+            novas[r][c] = (uint8_t)tipoPorChave(jogos[c].gerador.chave, jogos[c].gerador.posicao + (uint64_t)r);
+        }
+    }
+
+    double inicio = tempoAgora();
+    uint64_t soma_partidas = medirRodadasPartidas(jogos, rodadas);
+    double tempo_partidas = tempoAgora() - inicio;
+
+    FilasEmpacotadas filas = iniciais;
+    inicio = tempoAgora();
+    uint64_t soma_escalar = medirRodadasEmpacotadas(&OPERACOES_ESCALARES, &filas, (const uint8_t(*)[CANDIDATAS_EMPACOTADAS])novas, rodadas);
+    double tempo_escalar = tempoAgora() - inicio;
+
+    filas = iniciais;
+    inicio = tempoAgora();
+    uint64_t soma_escolhidas = medirRodadasEmpacotadas(escolhidas, &filas, (const uint8_t(*)[CANDIDATAS_EMPACOTADAS])novas, rodadas);
+    double tempo_escolhidas = tempoAgora() - inicio;
+
+    printf("%-*s | ns por rodada | Aceleração\n", 24 + bytesExtrasUtf8("Implementação"), "Implementação");
+    printf("%-*s | %13.1f | %9.2fx\n", 24 + bytesExtrasUtf8("Laço por partida"), "Laço por partida",
+           tempo_partidas / rodadas * 1e9, 1.0);
+    printf("%-24s | %13.1f | %9.2fx\n", "Empacotada escalar", tempo_escalar / rodadas * 1e9, tempo_partidas / tempo_escalar);
+    if (escolhidas != &OPERACOES_ESCALARES)
+    {
+        printf("Empacotada %-13s | %13.1f | %9.2fx\n", escolhidas->nome, tempo_escolhidas / rodadas * 1e9,
+               tempo_partidas / tempo_escolhidas);
+    }
+    printf("---------------------------------------------------\n");
+
+    free(novas);
+    free(jogos);
+    if (soma_escalar != soma_escolhidas)
+    {
+        printf("❌ As medições escalar e %s contaram peças diferentes.\n", escolhidas->nome);
+        return 1;
+    }
+    printf("✅ Somas de controle: empacotadas %llu | laço por partida %llu\n", (unsigned long long)soma_escolhidas,
+           (unsigned long long)soma_partidas);
+    return 0;
+}
+
+// --- Análise de Arquivos de Replay ---
+
+/*
+ * Formato do replay: uma partida por linha, "<semente> <jogo> <ações>\n", em que <ações> são
+ * os dígitos das opções do menu ('1' a '7') na ordem escolhida. Linhas começadas por '#' são
+ * comentários. Como o gerador é uma função pura de (semente, jogo, k), reexecutar as ações no
+ * motor reconstrói exatamente a partida, então o arquivo não precisa guardar as peças.
+ */
+
+/**
+ * @struct FatiaReplays
+ * Trecho [inicio, fim) do arquivo mapeado, sempre começando no início de uma linha, e as
+ * estatísticas parciais da thread que o processa.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) EstatisticasLote estatisticas;
+    uint64_t linhas_invalidas;
+    const char *inicio;
+    const char *fim;
+    pthread_t thread;
+} FatiaReplays;
+
+// Lê um número decimal sem depender de terminador nulo (o arquivo é mapeado, não é uma string)
+static const char *lerNumeroReplay(const char *p, const char *fim, uint64_t *valor)
+{
+    const char *inicio = p;
+    *valor = 0;
+    while (p < fim && *p >= '0' && *p <= '9')
+    {
+        *valor = *valor * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    return p == inicio ? NULL : p;
+}
+
+// Reexecuta uma linha de replay; retorna 0 se a linha estiver malformada
+static int reexecutarLinhaReplay(const char *p, const char *fim, EstatisticasLote *estatisticas)
+{
+    uint64_t semente, numero;
+    Jogo jogo;
+
+    p = lerNumeroReplay(p, fim, &semente);
+    if (p == NULL || p == fim || *p != ' ')
+    {
+        return 0;
+    }
+    p = lerNumeroReplay(p + 1, fim, &numero);
+    if (p == NULL || (p < fim && *p != ' '))
+    {
+        return 0;
+    }
+
+    inicializarJogo(&jogo, semente, numero);
+    for (p++; p < fim; p++)
+    {
+        if (*p < '0' + ACAO_JOGAR || *p > '0' + ACAO_VISUALIZAR)
+        {
+            break; // '0' (sair) ou lixo no fim da linha encerram a partida
+        }
+        Acao acao = (Acao)(*p - '0');
+        acumularResultado(estatisticas, &jogo, acao, executarAcao(&jogo, acao));
+    }
+
+    acumularFimDeJogo(estatisticas, &jogo);
+    return 1;
+}
+
+static void *analisarFatiaReplays(void *argumento)
+{
+    FatiaReplays *fatia = (FatiaReplays *)argumento;
+    EstatisticasLote local = {0};
+    uint64_t invalidas = 0;
+
+    const char *p = fatia->inicio;
+    while (p < fatia->fim)
+    {
+        const char *fim_linha = memchr(p, '\n', fatia->fim - p);
+        if (fim_linha == NULL)
+        {
+            fim_linha = fatia->fim;
+        }
+        if (fim_linha > p && *p != '#' && !reexecutarLinhaReplay(p, fim_linha, &local))
+        {
+            invalidas++;
+        }
+        p = fim_linha + 1;
+    }
+
+    fatia->estatisticas = local;
+    fatia->linhas_invalidas = invalidas;
+    return NULL;
+}
+
+static double porcentagem(uint64_t parte, uint64_t todo)
+{
+    return todo ? 100.0 * parte / todo : 0.0;
+}
+
+#ifdef __linux__
+/**
+ * Agrega estatísticas de um arquivo de replays sem carregá-lo para a memória: o arquivo é
+ * mapeado com leitura sequencial, dividido em T trechos alinhados em quebras de linha e cada
+ * thread reexecuta suas partidas acumulando contadores próprios, somados apenas no final.
+ */
+int executarAnaliseReplays(const char *caminho, int num_threads)
+{
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS)
+    {
+        num_threads = MAX_THREADS;
+    }
+
+    int descritor = open(caminho, O_RDONLY);
+    struct stat informacoes;
+    if (descritor < 0 || fstat(descritor, &informacoes) != 0)
+    {
+        perror(caminho);
+        if (descritor >= 0)
+        {
+            close(descritor);
+        }
+        return 1;
+    }
+
+    size_t tamanho = (size_t)informacoes.st_size;
+    const char *dados = NULL;
+    if (tamanho > 0)
+    {
+        dados = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+        if (dados == MAP_FAILED)
+        {
+            perror("mmap");
+            close(descritor);
+            return 1;
+        }
+        madvise((void *)dados, tamanho, MADV_SEQUENTIAL);
+    }
+    close(descritor);
+
+    FatiaReplays *fatias = alocarTrabalhadores(num_threads, sizeof(FatiaReplays));
+    if (fatias == NULL)
+    {
+        if (dados != NULL)
+        {
+            munmap((void *)dados, tamanho);
+        }
+        return 1;
+    }
+
+    double inicio = tempoAgora();
+
+    // Cada fronteira avança até depois da próxima quebra de linha, para nenhuma linha ser cortada
+    const char *fim_arquivo = dados + tamanho;
+    const char *anterior = dados;
+    for (int i = 0; i < num_threads; i++)
+    {
+        const char *limite = dados + tamanho * (uint64_t)(i + 1) / num_threads;
+        if (limite < anterior)
+        {
+            limite = anterior;
+        }
+        if (i + 1 < num_threads && limite > dados && limite < fim_arquivo && limite[-1] != '\n')
+        {
+            const char *quebra = memchr(limite, '\n', fim_arquivo - limite);
+            limite = quebra ? quebra + 1 : fim_arquivo;
+        }
+        fatias[i].inicio = anterior;
+        fatias[i].fim = limite;
+        anterior = limite;
+    }
+    if (!RODAR_TRABALHADORES(fatias, num_threads, analisarFatiaReplays, NULL))
+    {
+        free(fatias);
+        if (dados != NULL)
+        {
+            munmap((void *)dados, tamanho);
+        }
+        return 1;
+    }
+
+    EstatisticasLote total = {0};
+    uint64_t linhas_invalidas = 0;
+    for (int i = 0; i < num_threads; i++)
+    {
+        somarEstatisticas(&total, &fatias[i].estatisticas);
+        linhas_invalidas += fatias[i].linhas_invalidas;
+    }
+
+    double duracao = tempoAgora() - inicio;
+    free(fatias);
+    if (dados != NULL)
+    {
+        munmap((void *)dados, tamanho);
+    }
+
+    static const char *const NOMES_ACOES[] = {"", "Jogar", "Reservar", "Usar", "Trocar", "Desfazer", "Inverter", "Visualizar"};
+
+    printf("📼 Análise de Replays: %s\n", caminho);
+    printf("Partidas: %llu | Ações: %llu | Linhas inválidas: %llu | Threads: %d\n",
+           (unsigned long long)total.jogos, (unsigned long long)total.acoes,
+           (unsigned long long)linhas_invalidas, num_threads);
+    printf("---------------------------------------------------\n");
+    printf("Operação   | Escolhas        | Frequência\n");
+    for (int a = ACAO_JOGAR; a <= ACAO_VISUALIZAR; a++)
+    {
+        printf("%-10s | %15llu | %9.3f%%\n", NOMES_ACOES[a], (unsigned long long)total.tentativas[a],
+               porcentagem(total.tentativas[a], total.acoes));
+    }
+    printf("---------------------------------------------------\n");
+    printf("Reserva: %llu de %llu tentativas bloqueadas por pilha cheia (%.2f%%) | ocupação média %.2f/%d\n",
+           (unsigned long long)total.bloqueios_pilha_cheia, (unsigned long long)total.tentativas[ACAO_RESERVAR],
+           porcentagem(total.bloqueios_pilha_cheia, total.tentativas[ACAO_RESERVAR]),
+           total.acoes ? (double)total.soma_ocupacao_pilha / total.acoes : 0.0, CAPACIDADE_PILHA);
+    printf("Desfazer: %.2f%% das ações | %llu bem-sucedidos de %llu\n",
+           porcentagem(total.tentativas[ACAO_DESFAZER], total.acoes), (unsigned long long)total.desfeitas,
+           (unsigned long long)total.tentativas[ACAO_DESFAZER]);
+    printf("Inversões: %llu | Trocas: %llu | Ações recusadas: %llu (%.2f%%)\n",
+           (unsigned long long)total.inversoes, (unsigned long long)total.trocas,
+           (unsigned long long)total.recusadas, porcentagem(total.recusadas, total.acoes));
+    printf("IDs de peça: 1 a %llu (maior posição alcançada pelo gerador)\n", (unsigned long long)total.maior_id);
+    printf("Assinatura dos estados finais: %016llx\n", (unsigned long long)total.assinatura);
+    printf("---------------------------------------------------\n");
+    printf("Tempo: %.3f s | %.1f MB/s | %.1f milhões de ações/s\n", duracao,
+           tamanho / duracao / 1e6, total.acoes / duracao / 1e6);
+    return linhas_invalidas > 0;
+}
+#else
+int executarAnaliseReplays(const char *caminho, int num_threads)
+{
+    (void)caminho;
+    (void)num_threads;
+    printf("❌ A análise de replays usa mmap e só está disponível no Linux.\n");
+    return 1;
+}
+#endif
+
+// --- Tela com Buffer Duplo (redesenho diferencial) ---
+
+#define LINHAS_TELA 26
+#define COLUNAS_TELA 96
+#define SALTO_MAXIMO_REESCRITA 4 // Células iguais entre duas mudanças que compensa reescrever em vez de mover o cursor
+#define TAMANHO_SAIDA_TELA (LINHAS_TELA * COLUNAS_TELA * 12)
+
+/**
+ * @struct Tela
+ * Cada célula guarda um caractere UTF-8 (até 4 bytes) empacotado em um uint32_t.
+ * O quadro novo é montado em "tras"; apresentarTela compara com "frente" (o que o terminal
+ * está mostrando) e emite só os movimentos de cursor e as células que mudaram.
+ */
+typedef struct
+{
+    uint32_t frente[LINHAS_TELA][COLUNAS_TELA];
+    uint32_t tras[LINHAS_TELA][COLUNAS_TELA];
+    int primeira_apresentacao;
+} Tela;
+
+void limparTras(Tela *tela)
+{
+    for (int l = 0; l < LINHAS_TELA; l++)
+    {
+        for (int c = 0; c < COLUNAS_TELA; c++)
+        {
+            tela->tras[l][c] = ' ';
+        }
+    }
+}
+
+void inicializarTela(Tela *tela)
+{
+    limparTras(tela);
+    tela->primeira_apresentacao = 1;
+}
+
+/**
+ * Escreve um texto UTF-8 no quadro de trás a partir de (linha, coluna), uma célula por caractere.
+ * Retorna a coluna seguinte ao texto. O que passar da borda é descartado, assim como um
+ * caractere cortado no fim do texto (o vsnprintf de escreverTelaFormatado trunca em bytes).
+ */
+int escreverTela(Tela *tela, int linha, int coluna, const char *texto)
+{
+    const unsigned char *p = (const unsigned char *)texto;
+
+    while (*p != '\0')
+    {
+        int bytes = (*p >= 0xF0) ? 4 : (*p >= 0xE0) ? 3 : (*p >= 0xC0) ? 2 : 1;
+        uint32_t celula = *p;
+        int consumidos = 1;
+        // Só bytes de continuação (10xxxxxx) fazem parte do caractere; o NUL nunca
+        while (consumidos < bytes && (p[consumidos] & 0xC0) == 0x80)
+        {
+            celula |= (uint32_t)p[consumidos] << (8 * consumidos);
+            consumidos++;
+        }
+        if (consumidos < bytes && p[consumidos] == '\0')
+        {
+            break;
+        }
+        if (linha >= 0 && linha < LINHAS_TELA && coluna >= 0 && coluna < COLUNAS_TELA)
+        {
+            tela->tras[linha][coluna] = celula;
+        }
+        coluna++;
+        p += consumidos;
+    }
+    return coluna;
+}
+
+int escreverTelaFormatado(Tela *tela, int linha, int coluna, const char *formato, ...)
+{
+    char texto[COLUNAS_TELA * 4 + 1];
+    va_list argumentos;
+    va_start(argumentos, formato);
+    vsnprintf(texto, sizeof(texto), formato, argumentos);
+    va_end(argumentos);
+    return escreverTela(tela, linha, coluna, texto);
+}
+
+static int emitirCelula(char *saida, int n, uint32_t celula)
+{
+    do
+    {
+        saida[n++] = (char)(celula & 0xFF);
+        celula >>= 8;
+    } while (celula != 0);
+    return n;
+}
+
+/**
+ * Compara o quadro de trás com o da frente e escreve em saida só o necessário para o
+ * terminal passar a mostrar o quadro novo. Mudanças próximas na mesma linha são unidas
+ * para não pagar um movimento de cursor por célula. Retorna o número de bytes escritos.
+ */
+int apresentarTela(Tela *tela, char *saida)
+{
+    int n = 0;
+    int cursor_linha = -1;
+    int cursor_coluna = -1;
+
+    if (tela->primeira_apresentacao)
+    {
+        // Depois de limpar, o terminal mostra só espaços: é daí que o diferencial parte
+        n += sprintf(saida + n, "\033[H\033[2J");
+        for (int l = 0; l < LINHAS_TELA; l++)
+        {
+            for (int c = 0; c < COLUNAS_TELA; c++)
+            {
+                tela->frente[l][c] = ' ';
+            }
+        }
+        tela->primeira_apresentacao = 0;
+    }
+
+    for (int l = 0; l < LINHAS_TELA; l++)
+    {
+        int c = 0;
+        while (c < COLUNAS_TELA)
+        {
+            if (tela->tras[l][c] == tela->frente[l][c])
+            {
+                c++;
+                continue;
+            }
+
+            // Estende o trecho enquanto as células iguais no meio forem poucas
+            int fim = c + 1;
+            int iguais = 0;
+            for (int j = c + 1; j < COLUNAS_TELA && iguais <= SALTO_MAXIMO_REESCRITA; j++)
+            {
+                if (tela->tras[l][j] != tela->frente[l][j])
+                {
+                    fim = j + 1;
+                    iguais = 0;
+                }
+                else
+                {
+                    iguais++;
+                }
+            }
+
+            if (cursor_linha != l || cursor_coluna != c)
+            {
+                n += sprintf(saida + n, "\033[%d;%dH", l + 1, c + 1);
+            }
+            for (int k = c; k < fim; k++)
+            {
+                n = emitirCelula(saida, n, tela->tras[l][k]);
+                tela->frente[l][k] = tela->tras[l][k];
+            }
+            cursor_linha = l;
+            cursor_coluna = fim;
+            c = fim;
+        }
+    }
+    return n;
+}
+
+// Bytes que um redesenho completo do quadro atual custaria (para comparar com o diferencial)
+int tamanhoQuadroCompleto(const Tela *tela)
+{
+    int n = 7; // "\033[H\033[2J"
+    for (int l = 0; l < LINHAS_TELA; l++)
+    {
+        // Espaços no fim da linha não precisariam ser enviados
+        int ultima = COLUNAS_TELA;
+        while (ultima > 0 && tela->tras[l][ultima - 1] == ' ')
+        {
+            ultima--;
+        }
+        for (int c = 0; c < ultima; c++)
+        {
+            uint32_t celula = tela->tras[l][c];
+            n += (celula > 0xFFFFFF) ? 4 : (celula > 0xFFFF) ? 3 : (celula > 0xFF) ? 2 : 1;
+        }
+        n += 2; // "\r\n"
+    }
+    return n;
+}
+
+// --- Modo Tempo Real (gravidade, atraso de travamento e entrada sem bloqueio) ---
+
+#ifdef __linux__
+#define ALTURA_POCO 20
+#define LARGURA_POCO 10
+#define AMOSTRAS_TEMPO_REAL 8192
+#define GRAVIDADE_PADRAO 0.5        // Segundos por linha
+#define ATRASO_TRAVAMENTO_PADRAO 0.5 // Segundos apoiada no fundo antes de travar
+#define HZ_MINIMO_TEMPO_REAL 60
+#define JITTER_MAXIMO_TEMPO_REAL 0.01 // Fração do período
+
+/**
+ * @struct PartidaTempoReal
+ * A peça ativa é a frente da fila: ela cai pelo poço com a gravidade e, depois de ficar
+ * apoiada no fundo pelo atraso de travamento, é jogada (jogarPeca) e a próxima assume.
+ */
+typedef struct
+{
+    Jogo jogo;
+    int linha;                 // Linha da peça ativa no poço (0 = topo)
+    double proxima_queda;      // Instante da próxima queda por gravidade
+    double inicio_travamento;  // Instante em que a peça tocou o fundo (< 0 se ainda caindo)
+    int pecas_travadas;
+    int sair;
+} PartidaTempoReal;
+
+/**
+ * @struct MedicoesTempoReal
+ * Amostras de intervalo entre quadros e de latência entrada -> tela, em segundos.
+ */
+typedef struct
+{
+    double intervalos[AMOSTRAS_TEMPO_REAL];
+    int total_intervalos;
+    double latencias[AMOSTRAS_TEMPO_REAL];
+    int total_latencias;
+    uint64_t quadros;
+    uint64_t quadros_perdidos;
+    uint64_t bytes_escritos;
+    uint64_t bytes_quadro_completo; // Quanto custariam os mesmos quadros redesenhados por inteiro
+} MedicoesTempoReal;
+
+static struct termios terminal_original;
+static volatile sig_atomic_t terminal_alterado = 0;
+static volatile sig_atomic_t terminal_preparado = 0;
+static int flags_entrada_originais = -1; // O stdin é compartilhado com o shell: O_NONBLOCK precisa sair
+
+/**
+ * Devolve o terminal como estava: modo canônico com eco, flags originais do stdin e cursor
+ * visível. Usa só chamadas seguras em tratadores de sinal, porque também roda no Ctrl+C.
+ */
+static void restaurarTerminal()
+{
+    if (!terminal_preparado)
+    {
+        return;
+    }
+    if (terminal_alterado)
+    {
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminal_original);
+        terminal_alterado = 0;
+    }
+    if (flags_entrada_originais >= 0)
+    {
+        fcntl(STDIN_FILENO, F_SETFL, flags_entrada_originais);
+    }
+    static const char mostrar_cursor[] = "\033[?25h";
+    if (write(STDOUT_FILENO, mostrar_cursor, sizeof(mostrar_cursor) - 1) < 0)
+    {
+        // Sem terminal para onde escrever: nada a fazer
+    }
+    terminal_preparado = 0;
+}
+
+// Ctrl+C ou kill: restaura o terminal e termina com o sinal original
+static void interromperTempoReal(int sinal)
+{
+    restaurarTerminal();
+    signal(sinal, SIG_DFL);
+    raise(sinal);
+}
+
+// Terminal em modo cru: cada tecla chega na hora, sem eco e sem esperar Enter
+static void prepararTerminal()
+{
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = interromperTempoReal;
+    sigemptyset(&acao.sa_mask);
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+    sigaction(SIGHUP, &acao, NULL);
+
+    flags_entrada_originais = fcntl(STDIN_FILENO, F_GETFL);
+    terminal_preparado = 1;
+    if (tcgetattr(STDIN_FILENO, &terminal_original) == 0)
+    {
+        struct termios cru = terminal_original;
+        cru.c_lflag &= ~(ICANON | ECHO);
+        cru.c_cc[VMIN] = 0;
+        cru.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &cru);
+        terminal_alterado = 1;
+    }
+    if (flags_entrada_originais >= 0)
+    {
+        fcntl(STDIN_FILENO, F_SETFL, flags_entrada_originais | O_NONBLOCK);
+    }
+}
+
+// Sessão encerrada normalmente: terminal de volta e sinais com o comportamento padrão
+static void encerrarTerminal()
+{
+    fflush(stdout);
+    restaurarTerminal();
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGHUP, SIG_DFL);
+}
+
+static void reiniciarQueda(PartidaTempoReal *partida, double agora)
+{
+    partida->linha = 0;
+    partida->proxima_queda = agora + GRAVIDADE_PADRAO;
+    partida->inicio_travamento = -1.0;
+}
+
+static void travarPeca(PartidaTempoReal *partida, double agora)
+{
+    if (jogarPeca(&partida->jogo) == RESULTADO_OK)
+    {
+        partida->pecas_travadas++;
+    }
+    reiniciarQueda(partida, agora);
+}
+
+/**
+ * Avança a gravidade e o atraso de travamento até o instante agora.
+ * Retorna 1 se algo mudou na tela.
+ */
+static int atualizarGravidade(PartidaTempoReal *partida, double agora)
+{
+    int mudou = 0;
+
+    while (partida->linha < ALTURA_POCO - 1 && agora >= partida->proxima_queda)
+    {
+        partida->linha++;
+        partida->proxima_queda += GRAVIDADE_PADRAO;
+        mudou = 1;
+    }
+
+    if (partida->linha == ALTURA_POCO - 1)
+    {
+        if (partida->inicio_travamento < 0)
+        {
+            partida->inicio_travamento = agora;
+        }
+        else if (agora - partida->inicio_travamento >= ATRASO_TRAVAMENTO_PADRAO)
+        {
+            travarPeca(partida, agora);
+            mudou = 1;
+        }
+    }
+    return mudou;
+}
+
+// Aplica uma tecla. Retorna 1 se algo mudou na tela.
+static int processarTecla(PartidaTempoReal *partida, char tecla, double agora)
+{
+    Peca peca_usada;
+
+    switch (tecla)
+    {
+    case 's': // Desce uma linha
+        if (partida->linha < ALTURA_POCO - 1)
+        {
+            partida->linha++;
+        }
+        return 1;
+    case ' ': // Queda instantânea: trava na hora
+        travarPeca(partida, agora);
+        return 1;
+    case 'c': // Reserva a peça ativa
+        if (reservarPeca(&partida->jogo) == RESULTADO_OK)
+        {
+            reiniciarQueda(partida, agora);
+        }
+        return 1;
+    case 'x': // Troca a peça ativa com o topo da pilha
+        if (trocarPilhaFila(&partida->jogo) == RESULTADO_OK)
+        {
+            reiniciarQueda(partida, agora);
+        }
+        return 1;
+    case 'u': // Usa (descarta) a peça do topo da reserva
+        usarPecaReservada(&partida->jogo, &peca_usada);
+        return 1;
+    case 'z':
+        if (desfazerUltimaJogada(&partida->jogo) == RESULTADO_OK)
+        {
+            reiniciarQueda(partida, agora);
+        }
+        return 1;
+    case 'v':
+        inverterFilaComPilha(&partida->jogo);
+        reiniciarQueda(partida, agora);
+        return 1;
+    case 'q':
+        partida->sair = 1;
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+static double percentil(double *amostras, int total, double fracao)
+{
+    if (total == 0)
+    {
+        return 0.0;
+    }
+    qsort(amostras, total, sizeof(double), compararDouble);
+    return amostras[(int)((total - 1) * fracao)];
+}
+
+/**
+ * Monta o poço, a fila e a pilha no quadro de trás e envia só as diferenças
+ * para o terminal, com uma única chamada write().
+ */
+static void desenharTempoReal(const PartidaTempoReal *partida, Tela *tela, MedicoesTempoReal *medicoes, int hz)
+{
+    static char saida[TAMANHO_SAIDA_TELA];
+    const FilaCircular *fila = &partida->jogo.fila;
+    const Pilha *pilha = &partida->jogo.pilha;
+    const Peca *ativa = espiarFila(fila);
+
+    limparTras(tela);
+    escreverTelaFormatado(tela, 0, 0, "Tetris Stack - Tempo Real (%d Hz)", hz);
+
+    // Bordas do poço
+    for (int c = 0; c <= LARGURA_POCO + 1; c++)
+    {
+        escreverTela(tela, 1, c, (c == 0 || c == LARGURA_POCO + 1) ? "+" : "-");
+        escreverTela(tela, ALTURA_POCO + 2, c, (c == 0 || c == LARGURA_POCO + 1) ? "+" : "-");
+    }
+    for (int linha = 0; linha < ALTURA_POCO; linha++)
+    {
+        escreverTela(tela, linha + 2, 0, "|");
+        escreverTela(tela, linha + 2, LARGURA_POCO + 1, "|");
+    }
+    if (ativa != NULL)
+    {
+        escreverTela(tela, partida->linha + 2, LARGURA_POCO / 2, ativa->nome);
+    }
+
+    int coluna = escreverTela(tela, 3, LARGURA_POCO + 5, "Próximas:");
+    for (int i = 1; i < fila->tamanho; i++)
+    {
+        coluna = escreverTelaFormatado(tela, 3, coluna, " %s", fila->itens[(fila->frente + i) % CAPACIDADE_FILA].nome);
+    }
+    coluna = escreverTela(tela, 5, LARGURA_POCO + 5, "Reserva (topo primeiro):");
+    for (int i = pilha->topo; i >= 0; i--)
+    {
+        coluna = escreverTelaFormatado(tela, 5, coluna, " [%s]", pilha->itens[i].nome);
+    }
+    escreverTelaFormatado(tela, 7, LARGURA_POCO + 5, "Peças travadas: %d", partida->pecas_travadas);
+    escreverTela(tela, ALTURA_POCO + 3, 0, "s desce | espaço solta | c reserva | x troca | u usa | z desfaz | v inverte | q sai");
+
+    medicoes->bytes_quadro_completo += tamanhoQuadroCompleto(tela);
+    int n = apresentarTela(tela, saida);
+    medicoes->bytes_escritos += n;
+    medicoes->quadros++;
+    if (n > 0 && write(STDOUT_FILENO, saida, n) < 0)
+    {
+        return;
+    }
+}
+
+// Lê as teclas disponíveis e as aplica. Retorna -1 no fim da entrada, senão 1 se a tela mudou
+static int lerTeclasTempoReal(PartidaTempoReal *partida, double agora)
+{
+    char teclas[64];
+    ssize_t lidas = read(STDIN_FILENO, teclas, sizeof(teclas));
+    if (lidas == 0)
+    {
+        return -1;
+    }
+
+    int mudou = 0;
+    for (ssize_t i = 0; i < lidas; i++)
+    {
+        mudou |= processarTecla(partida, teclas[i], agora);
+    }
+    return mudou;
+}
+
+/**
+ * Laço de tempo real: um timerfd periódico dá o passo fixo (gravidade e travamento) e a
+ * entrada é lida sem bloquear assim que o epoll avisa, com redesenho imediato.
+ * Ao sair, relata a latência entrada -> tela e a variação do intervalo entre quadros, e
+ * falha se o passo ficou abaixo da meta: jitter de 1% do período ou algum passo perdido.
+ */
+int executarTempoReal(uint64_t semente, uint64_t numero_jogo, int hz)
+{
+    if (hz < HZ_MINIMO_TEMPO_REAL)
+    {
+        printf("❌ O modo tempo real precisa de pelo menos %d Hz.\n", HZ_MINIMO_TEMPO_REAL);
+        return 1;
+    }
+
+    static PartidaTempoReal partida;
+    static MedicoesTempoReal medicoes;
+    static Tela tela;
+    memset(&medicoes, 0, sizeof(medicoes));
+    inicializarTela(&tela);
+
+    inicializarJogo(&partida.jogo, semente, numero_jogo);
+    partida.pecas_travadas = 0;
+    partida.sair = 0;
+
+    int temporizador = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (temporizador < 0 || epoll < 0)
+    {
+        perror("timerfd/epoll");
+        if (temporizador >= 0)
+        {
+            close(temporizador);
+        }
+        return 1;
+    }
+
+    double periodo = 1.0 / hz;
+    long periodo_ns = 1000000000L / hz;
+    struct itimerspec intervalo = {0};
+    intervalo.it_interval.tv_sec = periodo_ns / 1000000000L;
+    intervalo.it_interval.tv_nsec = periodo_ns % 1000000000L;
+    intervalo.it_value = intervalo.it_interval;
+
+    struct epoll_event evento = {0};
+    evento.events = EPOLLIN;
+    evento.data.fd = temporizador;
+    if (timerfd_settime(temporizador, 0, &intervalo, NULL) != 0 ||
+        epoll_ctl(epoll, EPOLL_CTL_ADD, temporizador, &evento) != 0)
+    {
+        perror("timerfd_settime");
+        close(temporizador);
+        close(epoll);
+        return 1;
+    }
+
+    // Um arquivo comum no stdin (roteiro de teclas) não entra no epoll (EPERM), mas está
+    // sempre pronto: nesse caso as teclas são lidas a cada passo do temporizador
+    int entrada_a_cada_passo = 0;
+    evento.data.fd = STDIN_FILENO;
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, STDIN_FILENO, &evento) != 0)
+    {
+        if (errno != EPERM)
+        {
+            perror("epoll_ctl(stdin)");
+            close(temporizador);
+            close(epoll);
+            return 1;
+        }
+        entrada_a_cada_passo = 1;
+    }
+
+    prepararTerminal();
+    printf("\033[?25l"); // Esconde o cursor
+    fflush(stdout);
+
+    double agora = tempoAgora();
+    double ultimo_quadro = agora;
+    reiniciarQueda(&partida, agora);
+    desenharTempoReal(&partida, &tela, &medicoes, hz);
+
+    while (!partida.sair)
+    {
+        struct epoll_event eventos[2];
+        int prontos = epoll_wait(epoll, eventos, 2, -1);
+
+        for (int e = 0; e < prontos; e++)
+        {
+            agora = tempoAgora();
+
+            if (eventos[e].data.fd == temporizador)
+            {
+                uint64_t expiracoes = 0;
+                if (read(temporizador, &expiracoes, sizeof(expiracoes)) != sizeof(expiracoes))
+                {
+                    continue;
+                }
+                if (expiracoes > 1)
+                {
+                    medicoes.quadros_perdidos += expiracoes - 1;
+                }
+                if (medicoes.total_intervalos < AMOSTRAS_TEMPO_REAL)
+                {
+                    medicoes.intervalos[medicoes.total_intervalos++] = agora - ultimo_quadro;
+                }
+                ultimo_quadro = agora;
+
+                int mudou = atualizarGravidade(&partida, agora);
+                if (entrada_a_cada_passo)
+                {
+                    int teclas = lerTeclasTempoReal(&partida, agora);
+                    if (teclas < 0)
+                    {
+                        partida.sair = 1; // Fim do roteiro
+                        break;
+                    }
+                    mudou |= teclas;
+                }
+                if (mudou)
+                {
+                    desenharTempoReal(&partida, &tela, &medicoes, hz);
+                }
+            }
+            else
+            {
+                int mudou = lerTeclasTempoReal(&partida, agora);
+                if (mudou < 0)
+                {
+                    partida.sair = 1; // Fim da entrada
+                    break;
+                }
+                if (mudou)
+                {
+                    desenharTempoReal(&partida, &tela, &medicoes, hz);
+                    if (medicoes.total_latencias < AMOSTRAS_TEMPO_REAL)
+                    {
+                        medicoes.latencias[medicoes.total_latencias++] = tempoAgora() - agora;
+                    }
+                }
+            }
+        }
+    }
+
+    encerrarTerminal();
+    close(temporizador);
+    close(epoll);
+
+    // Variação (jitter) do intervalo entre quadros, em relação ao período nominal
+    double soma_quadrados = 0.0;
+    for (int i = 1; i < medicoes.total_intervalos; i++)
+    {
+        double desvio = medicoes.intervalos[i] - periodo;
+        soma_quadrados += desvio * desvio;
+    }
+    double jitter = medicoes.total_intervalos > 1 ? sqrt(soma_quadrados / (medicoes.total_intervalos - 1)) : 0.0;
+
+    printf("\n⏱️  Relatório do Modo Tempo Real\n");
+    printf("Peças travadas: %d | Quadros desenhados: %llu | Bytes enviados: %llu (%.0f por quadro)\n",
+           partida.pecas_travadas, (unsigned long long)medicoes.quadros,
+           (unsigned long long)medicoes.bytes_escritos,
+           medicoes.quadros ? (double)medicoes.bytes_escritos / medicoes.quadros : 0.0);
+    printf("Redesenho completo custaria %llu bytes: economia de %.1f%% com o redesenho diferencial\n",
+           (unsigned long long)medicoes.bytes_quadro_completo,
+           medicoes.bytes_quadro_completo ? 100.0 * (1.0 - (double)medicoes.bytes_escritos / medicoes.bytes_quadro_completo) : 0.0);
+    printf("Passo: %d Hz (%.3f ms) | Jitter: %.4f ms (%.2f%% do período) | Passos perdidos: %llu\n",
+           hz, periodo * 1e3, jitter * 1e3, 100.0 * jitter / periodo,
+           (unsigned long long)medicoes.quadros_perdidos);
+    printf("Latência entrada -> tela: p50 %.3f ms | p99 %.3f ms | máx %.3f ms (%d amostras)\n",
+           percentil(medicoes.latencias, medicoes.total_latencias, 0.50) * 1e3,
+           percentil(medicoes.latencias, medicoes.total_latencias, 0.99) * 1e3,
+           percentil(medicoes.latencias, medicoes.total_latencias, 1.0) * 1e3,
+           medicoes.total_latencias);
+
+    if (jitter >= JITTER_MAXIMO_TEMPO_REAL * periodo || medicoes.quadros_perdidos > 0)
+    {
+        printf("❌ Passo fixo fora da meta (jitter abaixo de %.0f%% do período e nenhum passo perdido).\n",
+               JITTER_MAXIMO_TEMPO_REAL * 100.0);
+        return 1;
+    }
+    printf("✅ Passo fixo dentro da meta: %d Hz com jitter abaixo de %.0f%% do período.\n", hz,
+           JITTER_MAXIMO_TEMPO_REAL * 100.0);
+    return 0;
+}
+#else
+int executarTempoReal(uint64_t semente, uint64_t numero_jogo, int hz)
+{
+    (void)semente;
+    (void)numero_jogo;
+    (void)hz;
+    printf("❌ O modo tempo real usa timerfd/epoll e só está disponível no Linux.\n");
+    return 1;
+}
+#endif
+
+// --- Estado Publicado em Memória Compartilhada ---
+
+static void copiarPecaPublicada(PecaPublicada *destino, Peca peca)
+{
+    destino->id = peca.id;
+    destino->tipo = peca.nome[0];
+}
+
+/**
+ * Monta o retrato publicado de uma partida (fila da frente para a traseira, pilha da base
+ * para o topo) e calcula o verificador.
+ */
+void preencherDadosPublicados(const Jogo *jogo, uint64_t acoes, const uint64_t *contagem_por_acao,
+                              DadosPublicados *dados)
+{
+    memset(dados, 0, sizeof(DadosPublicados));
+    dados->semente = jogo->gerador.semente;
+    dados->jogo = jogo->gerador.jogo;
+    dados->posicao_gerador = jogo->gerador.posicao;
+    dados->acoes = acoes;
+    memcpy(dados->contagem_por_acao, contagem_por_acao, sizeof(dados->contagem_por_acao));
+
+    dados->tamanho_fila = jogo->fila.tamanho;
+    for (int i = 0; i < jogo->fila.tamanho; i++)
+    {
+        copiarPecaPublicada(&dados->fila[i], jogo->fila.itens[(jogo->fila.frente + i) % CAPACIDADE_FILA]);
+    }
+    dados->tamanho_pilha = jogo->pilha.topo + 1;
+    for (int i = 0; i <= jogo->pilha.topo; i++)
+    {
+        copiarPecaPublicada(&dados->pilha[i], jogo->pilha.itens[i]);
+    }
+
+    dados->ultima_operacao = (int32_t)jogo->ultima_operacao;
+    copiarPecaPublicada(&dados->historico_jogada, jogo->peca_historico_jogada);
+    copiarPecaPublicada(&dados->historico_nova, jogo->peca_historico_nova);
+    dados->verificador = calcularVerificador(dados);
+}
+
+/**
+ * @struct PublicadorEstado
+ * Segmento POSIX shm mapeado pelo jogo para escrita.
+ */
+typedef struct
+{
+    EstadoPublicado *estado;
+    char nome[64];
+} PublicadorEstado;
+
+#ifdef __linux__
+int abrirPublicador(PublicadorEstado *publicador, const char *nome)
+{
+    int descritor = shm_open(nome, O_CREAT | O_RDWR, 0644);
+    if (descritor < 0)
+    {
+        perror(nome);
+        return 0;
+    }
+    if (ftruncate(descritor, sizeof(EstadoPublicado)) != 0)
+    {
+        perror("ftruncate");
+        close(descritor);
+        return 0;
+    }
+
+    void *mapa = mmap(NULL, sizeof(EstadoPublicado), PROT_READ | PROT_WRITE, MAP_SHARED, descritor, 0);
+    close(descritor);
+    if (mapa == MAP_FAILED)
+    {
+        perror("mmap");
+        return 0;
+    }
+
+    publicador->estado = mapa;
+    snprintf(publicador->nome, sizeof(publicador->nome), "%s", nome);
+    publicador->estado->sequencia = 0;
+    publicador->estado->versao = ESTADO_PUBLICADO_VERSAO;
+    __atomic_store_n(&publicador->estado->magico, ESTADO_PUBLICADO_MAGICO, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Desfaz o mapeamento e remove o nome; leitores que já mapearam continuam lendo o último retrato
+void fecharPublicador(PublicadorEstado *publicador)
+{
+    munmap(publicador->estado, sizeof(EstadoPublicado));
+    shm_unlink(publicador->nome);
+    publicador->estado = NULL;
+}
+#else
+int abrirPublicador(PublicadorEstado *publicador, const char *nome)
+{
+    (void)publicador;
+    (void)nome;
+    printf("❌ A publicação do estado usa POSIX shm e só está disponível no Linux.\n");
+    return 0;
+}
+
+void fecharPublicador(PublicadorEstado *publicador)
+{
+    (void)publicador;
+}
+#endif
+
+// --- Benchmark de Interferência Leitor/Escritor ---
+
+/**
+ * @struct LeitorInterferencia
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) uint64_t retratos;
+    uint64_t descartes;
+    uint64_t inconsistentes;
+    pthread_t thread;
+    const EstadoPublicado *estado;
+    const int *parar;
+} LeitorInterferencia;
+
+static void *executarLeitorInterferencia(void *argumento)
+{
+    LeitorInterferencia *leitor = argumento;
+    DadosPublicados retrato;
+    uint64_t retratos = 0, descartes = 0, inconsistentes = 0;
+
+    while (!__atomic_load_n(leitor->parar, __ATOMIC_RELAXED))
+    {
+        lerDadosPublicados(leitor->estado, &retrato, &descartes);
+        inconsistentes += retrato.verificador != calcularVerificador(&retrato);
+        retratos++;
+    }
+
+    leitor->retratos = retratos;
+    leitor->descartes = descartes;
+    leitor->inconsistentes = inconsistentes;
+    return NULL;
+}
+
+// Tempo de CPU da thread atual: não conta o tempo em que os leitores ocupam o núcleo
+static double tempoCpuThread()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Joga `total` ações publicando após cada uma (se estado != NULL); retorna ns de CPU por ação
+static double medirEscritorPublicando(EstadoPublicado *estado, uint64_t semente, uint64_t total)
+{
+    Jogo jogo;
+    DadosPublicados dados;
+    uint64_t contagem[ESTADO_NUM_ACOES] = {0};
+
+    inicializarJogo(&jogo, semente, 0);
+    double inicio = tempoCpuThread();
+    for (uint64_t i = 0; i < total; i++)
+    {
+        Acao acao = (Acao)(ACAO_JOGAR + misturarBits(jogo.gerador.chave + i) % 6);
+        executarAcao(&jogo, acao);
+        contagem[acao]++;
+        if (estado != NULL)
+        {
+            preencherDadosPublicados(&jogo, i + 1, contagem, &dados);
+            publicarDados(estado, &dados);
+        }
+    }
+    return (tempoCpuThread() - inicio) / total * 1e9;
+}
+
+/**
+ * Mede o custo de publicar para o jogo e a interferência de 0 a 4 leitores lendo sem parar
+ * o mesmo segmento. Cada retrato lido é conferido pelo verificador: um retrato misturando
+ * duas escritas seria contado como inconsistente.
+ */
+int executarInterferencia(uint64_t semente, uint64_t total)
+{
+    char nome[64];
+    PublicadorEstado publicador;
+    snprintf(nome, sizeof(nome), "/tetris-stack-interferencia-%d", (int)getpid());
+    if (!abrirPublicador(&publicador, nome))
+    {
+        return 1;
+    }
+
+    double sem_publicacao = medirEscritorPublicando(NULL, semente, total);
+
+    printf("🪟 Interferência Leitor/Escritor no Estado Publicado\n");
+    printf("Ações do escritor: %llu | Núcleos: %d | Retrato: %zu bytes\n", (unsigned long long)total,
+           contarNucleos(), sizeof(DadosPublicados));
+    printf("---------------------------------------------------\n");
+    printf("Sem publicação: %.1f ns por ação\n", sem_publicacao);
+    printf("Leitores | Escritor (ns de CPU/ação) | Custo extra | Retratos lidos/s | Descartes | Inconsistentes\n");
+
+    uint64_t total_inconsistentes = 0;
+    for (int num_leitores = 0; num_leitores <= 4; num_leitores = num_leitores ? num_leitores * 2 : 1)
+    {
+        LeitorInterferencia leitores[4];
+        int parar = 0;
+        memset(leitores, 0, sizeof(leitores));
+
+        double inicio = tempoAgora();
+        for (int i = 0; i < num_leitores; i++)
+        {
+            leitores[i].estado = publicador.estado;
+            leitores[i].parar = &parar;
+            int erro = pthread_create(&leitores[i].thread, NULL, executarLeitorInterferencia, &leitores[i]);
+            if (erro != 0)
+            {
+                // Os leitores rodam até o sinal de parada: avisa os já criados antes de esperá-los
+                printf("❌ Não foi possível criar o leitor %d de %d: %s\n", i + 1, num_leitores, strerror(erro));
+                __atomic_store_n(&parar, 1, __ATOMIC_RELAXED);
+                for (int j = 0; j < i; j++)
+                {
+                    pthread_join(leitores[j].thread, NULL);
+                }
+                fecharPublicador(&publicador);
+                return 1;
+            }
+        }
+
+        double escritor = medirEscritorPublicando(publicador.estado, semente, total);
+
+        __atomic_store_n(&parar, 1, __ATOMIC_RELAXED);
+        uint64_t retratos = 0, descartes = 0, inconsistentes = 0;
+        for (int i = 0; i < num_leitores; i++)
+        {
+            pthread_join(leitores[i].thread, NULL);
+            retratos += leitores[i].retratos;
+            descartes += leitores[i].descartes;
+            inconsistentes += leitores[i].inconsistentes;
+        }
+        double duracao = tempoAgora() - inicio;
+        total_inconsistentes += inconsistentes;
+
+        printf("%8d | %25.1f | %10.1f%% | %16.0f | %8.3f%% | %llu\n", num_leitores, escritor,
+               100.0 * (escritor - sem_publicacao) / sem_publicacao, retratos / duracao,
+               retratos + descartes ? 100.0 * descartes / (retratos + descartes) : 0.0,
+               (unsigned long long)inconsistentes);
+    }
+
+    fecharPublicador(&publicador);
+    printf("---------------------------------------------------\n");
+    if (total_inconsistentes > 0)
+    {
+        printf("❌ Leitores aceitaram retratos inconsistentes.\n");
+        return 1;
+    }
+    printf("✅ Todos os retratos aceitos pelos leitores eram consistentes.\n");
+    return 0;
+}
+
+// --- Início Rápido (sessões roteirizadas curtas, sem banner e sem stdio) ---
+
+/*
+ * Para orquestradores que abrem um processo por sessão curta. Não há banner, menu nem
+ * buffers de stdio. As opções chegam como bytes no stdin ('0' a '7'; espaços e quebras de
+ * linha são ignorados). Cada opção responde com uma linha no stdout:
+ *
+ *     <opção> <resultado> <fila, da frente para a traseira> <pilha, do topo para a base>
+ *     2 ok TLJSZ I
+ *
+ * As respostas são acumuladas e vão para o stdout com write(2) sempre que passam de
+ * TAMANHO_BLOCO_RAPIDO bytes, e o resto sai quando o bloco lido termina. Cada opção rende
+ * uma linha de até MAX_LINHA_RAPIDA bytes, então um bloco de entrada cheio de opções gera
+ * dezenas de writes, não um só.
+ * O estado pode vir do retrato gravado pela sessão anterior (--retrato), e a sessão pode
+ * gravar o seu (--gravar-retrato). Assim, uma partida longa pode ser dividida em muitos
+ * processos curtos sem reexecutar o histórico.
+ */
+
+#define RETRATO_MAGICO 0x4A544552u // "RETJ"
+#define RETRATO_VERSAO 2u // 2: ids de peça de 64 bits
+#define TAMANHO_BLOCO_RAPIDO 4096
+#define MAX_LINHA_RAPIDA 32
+
+static const char *const NOMES_RESULTADO[] = {"ok", "fila-vazia", "pilha-cheia", "pilha-vazia", "sem-historico"};
+
+/**
+ * @struct RetratoJogo
+ * A própria struct Jogo, precedida de um cabeçalho. O retrato só é aceito por um build com
+ * o mesmo sizeof(Jogo); o gerador sempre volta ao modo puro (sem arquivo de sequência).
+ */
+typedef struct
+{
+    uint32_t magico;
+    uint32_t versao;
+    uint32_t tamanho_jogo;
+    uint32_t reservado;
+    Jogo jogo;
+} RetratoJogo;
+
+#ifdef __linux__
+static int carregarRetrato(const char *caminho, Jogo *jogo)
+{
+    RetratoJogo retrato;
+    int descritor = open(caminho, O_RDONLY | O_CLOEXEC);
+    if (descritor < 0)
+    {
+        perror(caminho);
+        return 0;
+    }
+    ssize_t lidos = read(descritor, &retrato, sizeof(retrato));
+    close(descritor);
+
+    if (lidos != (ssize_t)sizeof(retrato) || retrato.magico != RETRATO_MAGICO || retrato.versao != RETRATO_VERSAO ||
+        retrato.tamanho_jogo != (uint32_t)sizeof(Jogo))
+    {
+        fprintf(stderr, "❌ %s não é um retrato deste build do Tetris Stack.\n", caminho);
+        return 0;
+    }
+    *jogo = retrato.jogo;
+    jogo->gerador.arquivo = NULL;
+    return 1;
+}
+
+// Grava num arquivo temporário e renomeia: quem abrir o retrato nunca o vê pela metade
+static int gravarRetrato(const char *caminho, const Jogo *jogo)
+{
+    RetratoJogo retrato;
+    memset(&retrato, 0, sizeof(retrato));
+    retrato.magico = RETRATO_MAGICO;
+    retrato.versao = RETRATO_VERSAO;
+    retrato.tamanho_jogo = (uint32_t)sizeof(Jogo);
+    retrato.jogo = *jogo;
+    retrato.jogo.gerador.arquivo = NULL;
+
+    char temporario[4096];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    int descritor = open(temporario, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    int ok = descritor >= 0 && write(descritor, &retrato, sizeof(retrato)) == (ssize_t)sizeof(retrato);
+    ok = descritor >= 0 && close(descritor) == 0 && ok;
+    if (!ok || rename(temporario, caminho) != 0)
+    {
+        perror(caminho);
+        unlink(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+static int escreverTudo(int descritor, const char *dados, size_t tamanho)
+{
+    while (tamanho > 0)
+    {
+        ssize_t escritos = write(descritor, dados, tamanho);
+        if (escritos < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return 0;
+        }
+        dados += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return 1;
+}
+
+// Escreve a linha de resposta de uma opção e devolve quantos bytes ela ocupa
+static size_t formatarLinhaRapida(char *linha, char opcao, const char *resultado, const Jogo *jogo)
+{
+    size_t n = 0;
+    linha[n++] = opcao;
+    linha[n++] = ' ';
+    for (const char *c = resultado; *c != '\0'; c++)
+    {
+        linha[n++] = *c;
+    }
+    linha[n++] = ' ';
+
+    const FilaCircular *fila = &jogo->fila;
+    for (int j = 0; j < fila->tamanho; j++)
+    {
+        linha[n++] = fila->itens[(fila->frente + j) % CAPACIDADE_FILA].nome[0];
+    }
+    if (fila->tamanho == 0)
+    {
+        linha[n++] = '-';
+    }
+    linha[n++] = ' ';
+
+    const Pilha *pilha = &jogo->pilha;
+    for (int j = pilha->topo; j >= 0; j--)
+    {
+        linha[n++] = pilha->itens[j].nome[0];
+    }
+    if (pilhaVazia(pilha))
+    {
+        linha[n++] = '-';
+    }
+    linha[n++] = '\n';
+    return n;
+}
+
+/**
+ * Sessão roteirizada: lê opções do stdin até '0' ou o fim da entrada e responde uma linha
+ * por opção. A partida é o jogo (semente, numero_jogo) ou o retrato de entrada, se houver.
+ */
+int executarSessaoRapida(uint64_t semente, uint64_t numero_jogo, const char *retrato_entrada, const char *retrato_saida)
+{
+    Jogo jogo;
+    if (retrato_entrada != NULL)
+    {
+        if (!carregarRetrato(retrato_entrada, &jogo))
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        inicializarJogo(&jogo, semente, numero_jogo);
+    }
+
+    char entrada[TAMANHO_BLOCO_RAPIDO];
+    char saida[TAMANHO_BLOCO_RAPIDO + MAX_LINHA_RAPIDA];
+    int terminou = 0;
+    while (!terminou)
+    {
+        ssize_t lidos = read(STDIN_FILENO, entrada, sizeof(entrada));
+        if (lidos < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (lidos <= 0)
+        {
+            break;
+        }
+
+        size_t tamanho_saida = 0;
+        for (ssize_t i = 0; i < lidos && !terminou; i++)
+        {
+            char opcao = entrada[i];
+            const char *resultado;
+            if (opcao == ' ' || opcao == '\n' || opcao == '\r' || opcao == '\t')
+            {
+                continue;
+            }
+            if (opcao == '0')
+            {
+                terminou = 1;
+                continue;
+            }
+            if (opcao >= '1' && opcao <= '7')
+            {
+                resultado = NOMES_RESULTADO[executarAcao(&jogo, (Acao)(opcao - '0'))];
+            }
+            else
+            {
+                resultado = "invalida";
+            }
+
+            tamanho_saida += formatarLinhaRapida(saida + tamanho_saida, opcao, resultado, &jogo);
+            if (tamanho_saida > TAMANHO_BLOCO_RAPIDO)
+            {
+                if (!escreverTudo(STDOUT_FILENO, saida, tamanho_saida))
+                {
+                    return 1;
+                }
+                tamanho_saida = 0;
+            }
+        }
+        if (tamanho_saida > 0 && !escreverTudo(STDOUT_FILENO, saida, tamanho_saida))
+        {
+            return 1;
+        }
+    }
+
+    if (retrato_saida != NULL && !gravarRetrato(retrato_saida, &jogo))
+    {
+        return 1;
+    }
+    return 0;
+}
+
+// --- Benchmark de Partida a Frio (do exec até a primeira opção respondida) ---
+
+#define SAIDA_MAXIMA_PARTIDA_FRIA 65536
+
+/**
+ * @struct VariantePartidaFria
+ */
+typedef struct
+{
+    const char *nome;
+    const char *binario;
+    int rapido;
+    double *primeira; // Do posix_spawn até a resposta da opção 1 chegar inteira
+    double *total;    // Do posix_spawn até o processo terminar
+    char resposta[MAX_LINHA_RAPIDA + 1]; // Primeira linha do modo rápido, para comparar as variantes
+} VariantePartidaFria;
+
+// A resposta da opção 1 está inteira: no menu, quando chega o segundo prompt; no modo rápido, a primeira linha
+static int respostaCompleta(const char *saida, size_t tamanho, int rapido)
+{
+    if (rapido)
+    {
+        return memchr(saida, '\n', tamanho) != NULL;
+    }
+    const char *primeiro = memmem(saida, tamanho, PROMPT_MENU, sizeof(PROMPT_MENU) - 1);
+    if (primeiro == NULL)
+    {
+        return 0;
+    }
+    size_t depois = (size_t)(primeiro - saida) + sizeof(PROMPT_MENU) - 1;
+    return memmem(saida + depois, tamanho - depois, PROMPT_MENU, sizeof(PROMPT_MENU) - 1) != NULL;
+}
+
+/**
+ * Uma partida a frio: "1\n0\n" já espera no stdin quando o processo nasce, como num
+ * orquestrador que entrega o roteiro inteiro de uma vez.
+ */
+static int medirPartidaFria(VariantePartidaFria *variante, int repeticao)
+{
+    static char saida[SAIDA_MAXIMA_PARTIDA_FRIA];
+    int entrada[2], resposta[2];
+    if (pipe2(entrada, O_CLOEXEC) != 0 || pipe2(resposta, O_CLOEXEC) != 0)
+    {
+        perror("pipe2");
+        return 0;
+    }
+    if (write(entrada[1], "1\n0\n", 4) != 4)
+    {
+        perror("write");
+        return 0;
+    }
+    close(entrada[1]);
+
+    posix_spawn_file_actions_t acoes;
+    posix_spawn_file_actions_init(&acoes);
+    posix_spawn_file_actions_adddup2(&acoes, entrada[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&acoes, resposta[1], STDOUT_FILENO);
+    char *argumentos[] = {(char *)variante->binario, "--semente", "1", variante->rapido ? "--rapido" : NULL, "1", NULL};
+
+    pid_t filho;
+    double inicio = tempoAgora();
+    int erro = posix_spawn(&filho, variante->binario, &acoes, NULL, argumentos, environ);
+    posix_spawn_file_actions_destroy(&acoes);
+    close(entrada[0]);
+    close(resposta[1]);
+    if (erro != 0)
+    {
+        fprintf(stderr, "❌ %s: %s\n", variante->binario, strerror(erro));
+        close(resposta[0]);
+        return 0;
+    }
+
+    size_t tamanho = 0;
+    double primeira = 0.0;
+    for (;;)
+    {
+        ssize_t lidos = read(resposta[0], saida + tamanho, sizeof(saida) - tamanho);
+        if (lidos <= 0)
+        {
             break;
         }
-        case 7:
-        { // Visualizar
-            // Já é feito no final do loop, mas permite visualização imediata
-            break;
+        tamanho += (size_t)lidos;
+        if (primeira == 0.0 && respostaCompleta(saida, tamanho, variante->rapido))
+        {
+            primeira = tempoAgora() - inicio;
         }
-        case 0:
+    }
+    int status;
+    waitpid(filho, &status, 0);
+    double total = tempoAgora() - inicio;
+    close(resposta[0]);
+
+    if (primeira == 0.0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        printf("❌ %s não respondeu à opção 1.\n", variante->nome);
+        return 0;
+    }
+    variante->primeira[repeticao] = primeira;
+    variante->total[repeticao] = total;
+    if (variante->rapido)
+    {
+        size_t fim = (size_t)((const char *)memchr(saida, '\n', tamanho) - saida);
+        size_t copiar = fim < MAX_LINHA_RAPIDA ? fim : MAX_LINHA_RAPIDA;
+        memcpy(variante->resposta, saida, copiar);
+        variante->resposta[copiar] = '\0';
+    }
+    return 1;
+}
+
+/**
+ * Mede o início a frio do próprio binário (menu e --rapido) e, se houver, de outro binário,
+ * por exemplo a build estática. As variantes se alternam a cada repetição para que ruído
+ * da máquina atinja todas igualmente.
+ */
+int executarPartidaFria(int repeticoes, const char *outro_binario)
+{
+    if (repeticoes < 1)
+    {
+        printf("❌ --partida-fria precisa de pelo menos 1 repetição.\n");
+        return 1;
+    }
+
+    VariantePartidaFria variantes[4] = {
+        {"menu", "/proc/self/exe", 0, NULL, NULL, ""},
+        {"--rapido", "/proc/self/exe", 1, NULL, NULL, ""},
+        {"menu (outro binário)", outro_binario, 0, NULL, NULL, ""},
+        {"--rapido (outro binário)", outro_binario, 1, NULL, NULL, ""},
+    };
+    int total_variantes = outro_binario != NULL ? 4 : 2;
+    int ok = 1;
+    for (int v = 0; v < total_variantes; v++)
+    {
+        variantes[v].primeira = malloc((size_t)repeticoes * sizeof(double));
+        variantes[v].total = malloc((size_t)repeticoes * sizeof(double));
+        ok = ok && variantes[v].primeira != NULL && variantes[v].total != NULL;
+    }
+
+    printf("🧊 Partida a Frio (do exec até a resposta da primeira opção)\n");
+    printf("Repetições: %d | Roteiro: \"1\\n0\\n\" no stdin | Outro binário: %s\n", repeticoes,
+           outro_binario != NULL ? outro_binario : "nenhum");
+    printf("---------------------------------------------------\n");
+    fflush(stdout);
+
+    for (int r = 0; ok && r < repeticoes; r++)
+    {
+        for (int v = 0; ok && v < total_variantes; v++)
         {
-            printf("\n👋 Desafio Mestre Concluído! Encerrando o programa.\n");
-            break;
+            ok = medirPartidaFria(&variantes[v], r);
         }
-        default:
+    }
+
+    if (ok)
+    {
+        printf("%-*s | 1ª opção p50 | 1ª opção p99 | até sair p50\n", 26 + bytesExtrasUtf8("Variante"), "Variante");
+        for (int v = 0; v < total_variantes; v++)
         {
-            printf("\n❌ Opção inválida. Tente novamente.\n");
-            break;
+            qsort(variantes[v].primeira, (size_t)repeticoes, sizeof(double), compararDouble);
+            qsort(variantes[v].total, (size_t)repeticoes, sizeof(double), compararDouble);
+            printf("%-*s | %9.3f ms | %9.3f ms | %9.3f ms\n", 26 + bytesExtrasUtf8(variantes[v].nome), variantes[v].nome,
+                   variantes[v].primeira[repeticoes / 2] * 1e3, variantes[v].primeira[(int)(repeticoes * 0.99)] * 1e3,
+                   variantes[v].total[repeticoes / 2] * 1e3);
+        }
+        printf("---------------------------------------------------\n");
+
+        // A resposta do modo rápido precisa ser a mesma que o motor dá dentro deste processo
+        Jogo jogo;
+        char esperada[MAX_LINHA_RAPIDA + 1];
+        inicializarJogo(&jogo, 1, 0);
+        size_t n = formatarLinhaRapida(esperada, '1', NOMES_RESULTADO[executarAcao(&jogo, ACAO_JOGAR)], &jogo);
+        esperada[n - 1] = '\0';
+        for (int v = 1; v < total_variantes; v += 2)
+        {
+            if (strcmp(variantes[v].resposta, esperada) != 0)
+            {
+                printf("❌ %s respondeu \"%s\"; o esperado era \"%s\".\n", variantes[v].nome, variantes[v].resposta, esperada);
+                ok = 0;
+            }
+        }
+        if (ok)
+        {
+            printf("✅ Resposta do modo rápido igual ao motor: \"%s\"\n", esperada);
+        }
+    }
+
+    for (int v = 0; v < total_variantes; v++)
+    {
+        free(variantes[v].primeira);
+        free(variantes[v].total);
+    }
+    return ok ? 0 : 1;
+}
+#else
+int executarSessaoRapida(uint64_t semente, uint64_t numero_jogo, const char *retrato_entrada, const char *retrato_saida)
+{
+    (void)semente;
+    (void)numero_jogo;
+    (void)retrato_entrada;
+    (void)retrato_saida;
+    printf("❌ O modo rápido usa read/write do POSIX e só está disponível no Linux.\n");
+    return 1;
+}
+
+int executarPartidaFria(int repeticoes, const char *outro_binario)
+{
+    (void)repeticoes;
+    (void)outro_binario;
+    printf("❌ O benchmark de partida a frio usa posix_spawn e só está disponível no Linux.\n");
+    return 1;
+}
+#endif
+
+// --- 8. Função Principal (main) e Menu de Execução ---
+
+#ifndef TETRIS_FUZZ
+int main(int argc, char *argv[])
+{
+    uint64_t semente = (uint64_t)time(NULL);
+    uint64_t numero_jogo = 0;
+    uint64_t pecas_analise = 0;
+    uint64_t operacoes_benchmark = 0;
+    uint64_t sequencias_verificacao = 0;
+    int tamanho_sequencia = 64;
+    int hz_tempo_real = 0;
+    uint64_t jogos_lote = 0;
+    int num_threads = 0; // 0 = não informado: cada modo usa o próprio padrão
+    const char *arquivo_replays = NULL;
+    const char *replays_analise = NULL;
+    uint64_t operacoes_escalonamento = 0;
+    uint64_t pecas_contencao = 0;
+    uint64_t acoes_maratona = 0;
+    uint64_t simulacoes_estrategias = 0;
+    uint64_t profundidade_previa = 0;
+    const char *nome_publicacao = NULL;
+    uint64_t acoes_interferencia = 0;
+    const char *caminho_servidor = NULL;
+    uint64_t duelos_versus = 0;
+    uint64_t rodadas_empacotadas = 0;
+    const char *saida_desempenho = NULL;
+    const char *base_desempenho = NULL;
+    double tolerancia_vazao = TOLERANCIA_VAZAO_PADRAO;
+    double tolerancia_p99 = TOLERANCIA_P99_PADRAO;
+    const char *gerar_sequencia = NULL;
+    const char *ler_sequencia = NULL;
+    const char *arquivo_sequencia = NULL;
+    uint64_t pecas_sequencia = 1000000;
+    int bits_sequencia = 3;
+    uint64_t passos_ambiente = 0;
+    int partidas_ambiente = 1024;
+    int modo_rapido = 0;
+    const char *retrato_entrada = NULL;
+    const char *retrato_saida = NULL;
+    int repeticoes_partida_fria = 0;
+    const char *binario_partida_fria = NULL;
+
+    // Argumentos opcionais:
+    //   --semente N --jogo G   reproduzem uma partida
+    //   --analisar N           analisa a distribuição de N peças em vez de abrir o menu
+    //   --threads T            número de threads dos modos de ferramenta (padrão: 1, salvo onde indicado)
+    //   --benchmark N          mede N operações do motor e verifica que nada é alocado
+    //   --verificar N          compara o motor com o modelo de referência em N sequências
+    //   --acoes A              ações por sequência da verificação (até 256) ou por partida do lote
+    //   --tempo-real HZ        jogo em tempo real com gravidade, passo fixo de HZ quadros/s
+    //   --lote K               simula K partidas em paralelo (com --threads e --acoes)
+    //   --gravar-replay ARQ    acrescenta as partidas do menu ou do lote ao arquivo de replays
+    //   --analisar-replays ARQ reexecuta um arquivo de replays e agrega estatísticas (com --threads)
+    //   --escalonamento N      mede N operações por thread de 1 até --threads threads (padrão: núcleos)
+    //   --contencao N          mede a FilaMPMC e a sequência compartilhada de 2 até --threads (padrão: 64)
+    //   --maratona N           joga N ações com histórico compacto e depois desfaz a partida inteira
+    //   --estrategias N        compara estratégias de reserva em N simulações de --acoes peças cada
+    //   --previa D             compara a prévia ansiosa de D peças com a janela preguiçosa
+    //   --publicar NOME        publica o estado do menu no segmento POSIX shm NOME (ex.: /tetris-stack-estado)
+    //   --interferencia N      mede a publicação do estado com 0 a 4 leitores em N ações
+    //   --servidor CAMINHO     serve o menu no socket Unix CAMINHO (um laço de eventos por --threads)
+    //   --versus N             simula N duelos entre dois bots com envio e cancelamento de lixo (com --threads)
+    //   --empacotadas N        confere e mede N rodadas das filas empacotadas (AVX2 ou escalar)
+    //   --desempenho ARQ       roda a suíte de desempenho e grava os resultados em ARQ (ex.: bench_output.txt)
+    //   --base ARQ             compara a suíte com a base ARQ e falha em caso de regressão
+    //   --tolerancia PCT       queda de vazão aceita em relação à base, em porcentagem (padrão 10)
+    //   --tolerancia-p99 PCT   aumento de p99 aceito em relação à base, em porcentagem (padrão 50)
+    //   --gerar-sequencia ARQ  grava --pecas N peças do jogo (--semente, --jogo) com --bits 3 ou 8 por peça
+    //   --ler-sequencia ARQ    percorre um arquivo de sequência, confere as peças e mede a leitura
+    //   --sequencia ARQ        o menu joga com as peças do arquivo (todos os jogadores recebem as mesmas)
+    //   --passos-ambiente N    confere e mede N passos da API de aprendizado por reforço (episódios de --acoes)
+    //   --ambientes E          partidas avançadas por chamada da API (padrão 1024)
+    //   --rapido 1             sessão roteirizada: sem banner nem menu, uma linha por opção lida do stdin
+    //   --retrato ARQ          o modo rápido continua a partida gravada em ARQ
+    //   --gravar-retrato ARQ   o modo rápido grava a partida em ARQ ao terminar
+    //   --partida-fria N       mede N vezes o tempo do exec até a primeira opção respondida
+    //   --binario CAMINHO      outro binário medido junto pela partida a frio (ex.: a build estática)
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--semente") == 0)
+        {
+            semente = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--jogo") == 0)
+        {
+            numero_jogo = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--analisar") == 0)
+        {
+            pecas_analise = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            num_threads = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            operacoes_benchmark = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--verificar") == 0)
+        {
+            sequencias_verificacao = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--acoes") == 0)
+        {
+            tamanho_sequencia = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--tempo-real") == 0)
+        {
+            hz_tempo_real = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--lote") == 0)
+        {
+            jogos_lote = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--gravar-replay") == 0)
+        {
+            arquivo_replays = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--analisar-replays") == 0)
+        {
+            replays_analise = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--escalonamento") == 0)
+        {
+            operacoes_escalonamento = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--contencao") == 0)
+        {
+            pecas_contencao = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--maratona") == 0)
+        {
+            acoes_maratona = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--estrategias") == 0)
+        {
+            simulacoes_estrategias = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--previa") == 0)
+        {
+            profundidade_previa = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--publicar") == 0)
+        {
+            nome_publicacao = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--interferencia") == 0)
+        {
+            acoes_interferencia = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--servidor") == 0)
+        {
+            caminho_servidor = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--versus") == 0)
+        {
+            duelos_versus = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--empacotadas") == 0)
+        {
+            rodadas_empacotadas = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--desempenho") == 0)
+        {
+            saida_desempenho = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--base") == 0)
+        {
+            base_desempenho = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--tolerancia") == 0)
+        {
+            tolerancia_vazao = atof(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--tolerancia-p99") == 0)
+        {
+            tolerancia_p99 = atof(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--gerar-sequencia") == 0)
+        {
+            gerar_sequencia = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--ler-sequencia") == 0)
+        {
+            ler_sequencia = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--sequencia") == 0)
+        {
+            arquivo_sequencia = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--pecas") == 0)
+        {
+            pecas_sequencia = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--bits") == 0)
+        {
+            bits_sequencia = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--passos-ambiente") == 0)
+        {
+            passos_ambiente = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--ambientes") == 0)
+        {
+            partidas_ambiente = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--rapido") == 0)
+        {
+            modo_rapido = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--retrato") == 0)
+        {
+            retrato_entrada = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--gravar-retrato") == 0)
+        {
+            retrato_saida = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--partida-fria") == 0)
+        {
+            repeticoes_partida_fria = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--binario") == 0)
+        {
+            binario_partida_fria = argv[i + 1];
+        }
+    }
+
+    if (pecas_analise > 0)
+    {
+        return executarAnaliseDistribuicao(semente, numero_jogo, pecas_analise, num_threads);
+    }
+    if (operacoes_benchmark > 0)
+    {
+        return executarBenchmarkMotor(semente, operacoes_benchmark);
+    }
+    if (sequencias_verificacao > 0)
+    {
+        return executarVerificacaoDiferencial(semente, sequencias_verificacao, tamanho_sequencia);
+    }
+    if (hz_tempo_real > 0)
+    {
+        return executarTempoReal(semente, numero_jogo, hz_tempo_real);
+    }
+    if (jogos_lote > 0)
+    {
+        return executarLote(semente, jogos_lote, num_threads, tamanho_sequencia, arquivo_replays);
+    }
+    if (replays_analise != NULL)
+    {
+        return executarAnaliseReplays(replays_analise, num_threads);
+    }
+    if (operacoes_escalonamento > 0)
+    {
+        return executarEscalonamento(semente, operacoes_escalonamento, num_threads);
+    }
+    if (pecas_contencao > 0)
+    {
+        return executarContencao(semente, pecas_contencao, num_threads);
+    }
+    if (acoes_maratona > 0)
+    {
+        return executarMaratona(semente, numero_jogo, acoes_maratona);
+    }
+    if (simulacoes_estrategias > 0)
+    {
+        return executarAvaliacaoEstrategias(semente, simulacoes_estrategias, tamanho_sequencia, num_threads);
+    }
+    if (profundidade_previa > MAX_PROFUNDIDADE_PREVIA)
+    {
+        printf("❌ Profundidade de prévia acima do máximo de %u peças.\n", MAX_PROFUNDIDADE_PREVIA);
+        return 1;
+    }
+    if (profundidade_previa > 0)
+    {
+        return executarBenchmarkPrevia(semente, profundidade_previa);
+    }
+    if (acoes_interferencia > 0)
+    {
+        return executarInterferencia(semente, acoes_interferencia);
+    }
+    if (caminho_servidor != NULL)
+    {
+        return executarServidor(caminho_servidor, semente, num_threads);
+    }
+    if (duelos_versus > 0)
+    {
+        return executarVersus(semente, duelos_versus, num_threads);
+    }
+    if (rodadas_empacotadas > 0)
+    {
+        return executarFilasEmpacotadas(semente, rodadas_empacotadas);
+    }
+    if (saida_desempenho != NULL)
+    {
+        return executarSuiteDesempenho(semente, saida_desempenho, base_desempenho, tolerancia_vazao, tolerancia_p99);
+    }
+    if (gerar_sequencia != NULL)
+    {
+        return executarGeracaoSequencia(gerar_sequencia, semente, numero_jogo, pecas_sequencia, bits_sequencia);
+    }
+    if (ler_sequencia != NULL)
+    {
+        return executarLeituraSequencia(ler_sequencia);
+    }
+    if (passos_ambiente > 0)
+    {
+        return executarAmbiente(semente, passos_ambiente, partidas_ambiente, tamanho_sequencia);
+    }
+    if (modo_rapido)
+    {
+        return executarSessaoRapida(semente, numero_jogo, retrato_entrada, retrato_saida);
+    }
+    if (repeticoes_partida_fria > 0)
+    {
+        return executarPartidaFria(repeticoes_partida_fria, binario_partida_fria);
+    }
+
+    Jogo jogo;
+    int opcao;
+
+    // Opções escolhidas na partida, gravadas como uma linha de replay ao sair
+    size_t capacidade_replay = 256;
+    size_t tamanho_replay = 0;
+    char *acoes_replay = arquivo_replays ? malloc(capacidade_replay) : NULL;
+
+    // Estado publicado para ferramentas externas (leitor-estado), atualizado após cada ação
+    PublicadorEstado publicador = {NULL, ""};
+    DadosPublicados dados_publicados;
+    uint64_t contagem_por_acao[ESTADO_NUM_ACOES] = {0};
+    uint64_t acoes_escolhidas = 0;
+
+    // Inicialização: peças do gerador puro ou, num torneio, do arquivo de sequência compartilhado
+    SequenciaArquivo sequencia = {NULL, 0, NULL, NULL, 0, 0};
+    if (arquivo_sequencia != NULL)
+    {
+        if (!abrirSequenciaArquivo(&sequencia, arquivo_sequencia))
+        {
+            return 1;
+        }
+        GeradorPecas gerador;
+        inicializarGeradorComArquivo(&gerador, &sequencia);
+        inicializarJogoComGerador(&jogo, &gerador);
+    }
+    else
+    {
+        inicializarJogo(&jogo, semente, numero_jogo);
+    }
+
+    if (nome_publicacao != NULL)
+    {
+        if (!abrirPublicador(&publicador, nome_publicacao))
+        {
+            return 1;
+        }
+        preencherDadosPublicados(&jogo, acoes_escolhidas, contagem_por_acao, &dados_publicados);
+        publicarDados(publicador.estado, &dados_publicados);
+    }
+
+    Saida terminal = {stdout, NULL, 0, 0};
+    exibirBoasVindas(&terminal, &jogo);
+
+    do
+    {
+        exibirMenu(&terminal);
+
+        if (scanf("%d", &opcao) != 1)
+        {
+            int c;
+            while ((c = getchar()) != '\n' && c != EOF)
+                ;
+            if (c == EOF)
+            {
+                opcao = 0; // Fim da entrada encerra a partida (e grava o replay)
+                break;
+            }
+            printf("🚫 Entrada inválida. Por favor, digite um número.\n");
+            opcao = -1;
+            continue;
+        }
+
+        if (opcao >= ACAO_SAIR && opcao <= ACAO_VISUALIZAR)
+        {
+            contagem_por_acao[opcao]++;
+            acoes_escolhidas++;
         }
+
+        if (acoes_replay != NULL && opcao >= ACAO_JOGAR && opcao <= ACAO_VISUALIZAR)
+        {
+            if (tamanho_replay == capacidade_replay)
+            {
+                char *ampliado = realloc(acoes_replay, capacidade_replay * 2);
+                if (ampliado == NULL)
+                {
+                    // Um replay incompleto reproduziria outra partida: melhor não gravar nenhum
+                    printf("⚠️ Memória insuficiente para o replay; esta partida não será gravada.\n");
+                    free(acoes_replay);
+                    acoes_replay = NULL;
+                }
+                else
+                {
+                    acoes_replay = ampliado;
+                    capacidade_replay *= 2;
+                }
+            }
+            if (acoes_replay != NULL)
+            {
+                acoes_replay[tamanho_replay++] = (char)('0' + opcao);
+            }
         }
 
-        // Exibe ambos após qualquer ação (exceto sair)
-        if (opcao != 0)
+        processarOpcaoMenu(&jogo, opcao, &terminal);
+
+        if (publicador.estado != NULL)
         {
-            visualizarFila(&fila_futuras);
-            visualizarPilha(&pilha_reserva);
+            preencherDadosPublicados(&jogo, acoes_escolhidas, contagem_por_acao, &dados_publicados);
+            publicarDados(publicador.estado, &dados_publicados);
         }
 
     } while (opcao != 0);
 
+    if (acoes_replay != NULL)
+    {
+        FILE *replay = fopen(arquivo_replays, "a");
+        if (replay != NULL)
+        {
+            fprintf(replay, "%llu %llu %.*s\n", (unsigned long long)jogo.gerador.semente,
+                    (unsigned long long)jogo.gerador.jogo, (int)tamanho_replay, acoes_replay);
+            fclose(replay);
+        }
+        else
+        {
+            perror(arquivo_replays);
+        }
+        free(acoes_replay);
+    }
+
+    if (publicador.estado != NULL)
+    {
+        fecharPublicador(&publicador);
+    }
+    fecharSequenciaArquivo(&sequencia);
+
     return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
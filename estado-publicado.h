@@ -0,0 +1,123 @@
+/*
+ * Estado do jogo publicado em memória compartilhada (POSIX shm) para ferramentas externas.
+ *
+ * O jogo escreve, e qualquer número de leitores lê, sem travas e sem chamadas de sistema
+ * depois do mmap. A consistência vem de um seqlock: o escritor deixa a sequência ímpar
+ * enquanto copia os dados e par quando termina; o leitor copia os dados e só aceita a cópia
+ * se a sequência era par e não mudou durante a cópia. O escritor nunca espera pelos leitores.
+ *
+ * O layout usa apenas tipos de tamanho fixo, para que leitores compilados separadamente
+ * (como leitor-estado.c) enxerguem exatamente os mesmos bytes.
+ */
+#ifndef ESTADO_PUBLICADO_H
+#define ESTADO_PUBLICADO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ESTADO_PUBLICADO_NOME "/tetris-stack-estado"
+#define ESTADO_PUBLICADO_MAGICO 0x54455452u // "TETR"
+#define ESTADO_PUBLICADO_VERSAO 2u // 2: ids de 64 bits
+#define ESTADO_FILA_MAX 5
+#define ESTADO_PILHA_MAX 3
+#define ESTADO_NUM_ACOES 8
+
+/**
+ * @struct PecaPublicada
+ */
+typedef struct
+{
+    uint64_t id;
+    char tipo;
+    char reservado[7];
+} PecaPublicada;
+
+/**
+ * @struct DadosPublicados
+ * Um retrato da partida. A fila vem da frente para a traseira e a pilha da base para o topo.
+ */
+typedef struct
+{
+    uint64_t semente;
+    uint64_t jogo;
+    uint64_t posicao_gerador;                      // Peças geradas até agora
+    uint64_t acoes;                                // Ações escolhidas pelo jogador
+    uint64_t contagem_por_acao[ESTADO_NUM_ACOES]; // Indexado pelo número da opção do menu
+    int32_t tamanho_fila;
+    int32_t tamanho_pilha;
+    PecaPublicada fila[ESTADO_FILA_MAX];
+    PecaPublicada pilha[ESTADO_PILHA_MAX];
+    int32_t ultima_operacao; // 0 = nenhuma, 1 = jogar, 2 = reservar
+    int32_t reservado;
+    PecaPublicada historico_jogada;
+    PecaPublicada historico_nova;
+    uint64_t verificador; // Hash dos campos acima, para conferir retratos nos testes
+} DadosPublicados;
+
+/**
+ * @struct EstadoPublicado
+ * Conteúdo do segmento. A sequência fica sozinha numa linha de cache, separada dos dados.
+ */
+typedef struct
+{
+    uint32_t magico;
+    uint32_t versao;
+    _Alignas(64) uint64_t sequencia;
+    _Alignas(64) DadosPublicados dados;
+} EstadoPublicado;
+
+// Mistura (no estilo FNV) das palavras de 64 bits dos dados antes do verificador
+static inline uint64_t calcularVerificador(const DadosPublicados *dados)
+{
+    const unsigned char *bytes = (const unsigned char *)dados;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < offsetof(DadosPublicados, verificador); i += sizeof(uint64_t))
+    {
+        uint64_t palavra;
+        memcpy(&palavra, bytes + i, sizeof(palavra));
+        hash = (hash ^ palavra) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+/**
+ * Escritor (uma única thread): publica um novo retrato sem nunca esperar pelos leitores.
+ */
+static inline void publicarDados(EstadoPublicado *estado, const DadosPublicados *dados)
+{
+    uint64_t sequencia = __atomic_load_n(&estado->sequencia, __ATOMIC_RELAXED);
+    __atomic_store_n(&estado->sequencia, sequencia + 1, __ATOMIC_RELAXED); // Ímpar: escrita em andamento
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&estado->dados, dados, sizeof(DadosPublicados));
+    __atomic_store_n(&estado->sequencia, sequencia + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * Leitor: copia um retrato consistente para destino. Retorna a sequência do retrato e soma
+ * em *tentativas quantas cópias foram descartadas por coincidirem com uma escrita.
+ */
+static inline uint64_t lerDadosPublicados(const EstadoPublicado *estado, DadosPublicados *destino,
+                                          uint64_t *tentativas)
+{
+    for (;;)
+    {
+        uint64_t antes = __atomic_load_n(&estado->sequencia, __ATOMIC_ACQUIRE);
+        if ((antes & 1) == 0)
+        {
+            memcpy(destino, (const void *)&estado->dados, sizeof(DadosPublicados));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&estado->sequencia, __ATOMIC_RELAXED) == antes)
+            {
+                return antes;
+            }
+        }
+        if (tentativas != NULL)
+        {
+            (*tentativas)++;
+        }
+    }
+}
+
+#endif
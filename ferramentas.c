@@ -0,0 +1,162 @@
+// Infraestrutura dos modos de ferramenta; a interface e a documentação estão em ferramentas.h
+// Extensões GNU: afinidade de threads (pthread_setaffinity_np, CPU_SET)
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "ferramentas.h"
+
+// --- Utilidades dos Modos de Ferramenta ---
+
+double tempoAgora()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int compararDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int bytesExtrasUtf8(const char *texto)
+{
+    int extras = 0;
+    for (; *texto; texto++)
+    {
+        extras += ((unsigned char)*texto & 0xC0) == 0x80;
+    }
+    return extras;
+}
+
+// --- Pool de Sessões Alinhadas ---
+
+int criarPoolSessoes(PoolSessoes *pool, int capacidade)
+{
+    pool->sessoes = aligned_alloc(TAMANHO_LINHA_CACHE, capacidade * sizeof(SessaoJogo));
+    if (pool->sessoes == NULL)
+    {
+        pool->capacidade = 0;
+        return 0;
+    }
+    memset(pool->sessoes, 0, capacidade * sizeof(SessaoJogo));
+    pool->capacidade = capacidade;
+    return 1;
+}
+
+void liberarPoolSessoes(PoolSessoes *pool)
+{
+    free(pool->sessoes);
+    pool->sessoes = NULL;
+    pool->capacidade = 0;
+}
+
+int contarNucleos()
+{
+    int num_cpus = 1;
+#ifdef __linux__
+    num_cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cpus < 1)
+    {
+        num_cpus = 1;
+    }
+#endif
+    return num_cpus;
+}
+
+void fixarThreadNoNucleo(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    CPU_SET(cpu, &conjunto);
+    pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto);
+#else
+    (void)cpu;
+#endif
+}
+
+// --- Threads Trabalhadoras (alocação, largada, criação e espera) ---
+
+int aguardarLargada(LargadaTrabalhadores *largada)
+{
+    pthread_mutex_lock(&largada->portao);
+    int abortada = largada->abortada;
+    pthread_mutex_unlock(&largada->portao);
+    if (abortada)
+    {
+        return 0;
+    }
+    pthread_barrier_wait(&largada->barreira);
+    return 1;
+}
+
+void *alocarTrabalhadores(int n, size_t tamanho)
+{
+    void *trabalhadores = aligned_alloc(TAMANHO_LINHA_CACHE, (size_t)n * tamanho);
+    if (trabalhadores == NULL)
+    {
+        printf("❌ Memória insuficiente para %d threads.\n", n);
+        return NULL;
+    }
+    memset(trabalhadores, 0, (size_t)n * tamanho);
+    return trabalhadores;
+}
+
+int rodarTrabalhadores(void *trabalhadores, int n, size_t tamanho, size_t deslocamento_thread,
+                       void *(*rotina)(void *), LargadaTrabalhadores *largada)
+{
+    if (largada != NULL)
+    {
+        int erro = pthread_barrier_init(&largada->barreira, NULL, (unsigned)n);
+        if (erro != 0)
+        {
+            printf("❌ Não foi possível criar a barreira de largada: %s\n", strerror(erro));
+            return 0;
+        }
+        pthread_mutex_init(&largada->portao, NULL);
+        largada->abortada = 0;
+        pthread_mutex_lock(&largada->portao);
+    }
+
+    int criadas = 0;
+    int falhou = 0;
+    for (; criadas < n; criadas++)
+    {
+        char *trabalhador = (char *)trabalhadores + (size_t)criadas * tamanho;
+        int erro = pthread_create((pthread_t *)(trabalhador + deslocamento_thread), NULL, rotina, trabalhador);
+        if (erro != 0)
+        {
+            printf("❌ Não foi possível criar a thread %d de %d: %s\n", criadas + 1, n, strerror(erro));
+            falhou = 1;
+            break;
+        }
+    }
+
+    if (largada != NULL)
+    {
+        largada->abortada = falhou;
+        pthread_mutex_unlock(&largada->portao);
+    }
+    for (int i = 0; i < criadas; i++)
+    {
+        pthread_join(*(pthread_t *)((char *)trabalhadores + (size_t)i * tamanho + deslocamento_thread), NULL);
+    }
+    if (largada != NULL)
+    {
+        pthread_mutex_destroy(&largada->portao);
+        pthread_barrier_destroy(&largada->barreira);
+    }
+    return !falhou;
+}
@@ -0,0 +1,127 @@
+/*
+ * Infraestrutura compartilhada pelos modos de ferramenta do nível Mestre (execução sem menu):
+ * medição de tempo, pool de sessões alinhadas, afinidade de núcleos e threads trabalhadoras.
+ * Também declara os modos que vivem em arquivos próprios, chamados pelo main de desafio-mestre.c.
+ */
+#ifndef FERRAMENTAS_H
+#define FERRAMENTAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "motor.h"
+
+// --- Utilidades dos Modos de Ferramenta ---
+
+#define MAX_THREADS 256
+#define OPERACOES_POR_JANELA 1024
+#define BLOCO_ANALISE 4096 // Peças geradas por vez nas análises de sequência
+
+// Tempo monotônico em segundos, para medir vazão
+double tempoAgora();
+
+// Ordem crescente, para qsort de tempos
+int compararDouble(const void *a, const void *b);
+
+// Bytes de continuação UTF-8 do texto, para alinhar colunas com acentos no printf
+int bytesExtrasUtf8(const char *texto);
+
+// --- Pool de Sessões Alinhadas ---
+
+#define TAMANHO_LINHA_CACHE 64
+
+/**
+ * @struct SessaoJogo
+ * Uma partida ocupando linhas de cache exclusivas: o alinhamento faz sizeof ser múltiplo de
+ * 64, então duas sessões vizinhas nunca compartilham uma linha, mesmo que sejam escritas
+ * por threads diferentes.
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) Jogo jogo;
+} SessaoJogo;
+
+/**
+ * @struct PoolSessoes
+ * Tabela de sessões alocada de uma vez, alinhada à linha de cache.
+ */
+typedef struct
+{
+    SessaoJogo *sessoes;
+    int capacidade;
+} PoolSessoes;
+
+int criarPoolSessoes(PoolSessoes *pool, int capacidade);
+
+void liberarPoolSessoes(PoolSessoes *pool);
+
+static inline Jogo *obterSessao(PoolSessoes *pool, int indice)
+{
+    return &pool->sessoes[indice].jogo;
+}
+
+// Número de núcleos disponíveis (1 fora do Linux)
+int contarNucleos();
+
+// Fixa a thread atual em um núcleo, para que o primeiro toque nas sessões seja local a ele
+void fixarThreadNoNucleo(int cpu);
+
+// --- Threads Trabalhadoras (alocação, largada, criação e espera) ---
+
+/**
+ * @struct LargadaTrabalhadores
+ * Solta juntas as threads de uma medição. A barreira faz a largada; o portão fica trancado
+ * pela thread principal enquanto ela cria as threads: se uma criação falhar, as que já
+ * existem saem pelo portão sem chegar à barreira, que nunca seria completada.
+ */
+typedef struct
+{
+    pthread_barrier_t barreira;
+    pthread_mutex_t portao;
+    int abortada;
+} LargadaTrabalhadores;
+
+// Chamada pela trabalhadora antes do trecho medido; retorna 0 se a rodada foi abortada
+int aguardarLargada(LargadaTrabalhadores *largada);
+
+/**
+ * Vetor de n trabalhadores alinhado à linha de cache e zerado. As structs de trabalhador
+ * começam com um campo _Alignas(TAMANHO_LINHA_CACHE), então nenhuma divide linha com a vizinha.
+ */
+void *alocarTrabalhadores(int n, size_t tamanho);
+
+/**
+ * Cria uma thread por trabalhador e espera todas terminarem. O trabalhador i fica em
+ * trabalhadores + i * tamanho e guarda seu pthread_t em deslocamento_thread; cada rotina se
+ * fixa no núcleo que recebeu. Com uma largada (ou NULL), as threads esperam em
+ * aguardarLargada até todas existirem. Se alguma não puder ser criada, as já criadas são
+ * esperadas (com largada, saem sem rodar) e retorna 0: os resultados não valem.
+ */
+int rodarTrabalhadores(void *trabalhadores, int n, size_t tamanho, size_t deslocamento_thread,
+                       void *(*rotina)(void *), LargadaTrabalhadores *largada);
+
+// Para vetores de structs com um campo `thread`
+#define RODAR_TRABALHADORES(vetor, n, rotina, largada)                                                             \
+    rodarTrabalhadores((vetor), (n), sizeof(*(vetor)), (size_t)((char *)&(vetor)->thread - (char *)(vetor)), (rotina), \
+                       (largada))
+
+// --- Modos de Ferramenta em Arquivos Próprios ---
+
+// servidor-sessoes.c
+int executarServidor(const char *caminho, uint64_t semente, int num_threads);
+
+// suite-desempenho.c
+#define TOLERANCIA_VAZAO_PADRAO 10.0 // Porcentagem
+#define TOLERANCIA_P99_PADRAO 50.0   // O p99 de janelas oscila bem mais que a vazão
+int executarSuiteDesempenho(uint64_t semente, const char *saida, const char *arquivo_base, double tolerancia_vazao,
+                            double tolerancia_p99);
+
+// arquivos-sequencia.c
+int executarGeracaoSequencia(const char *caminho, uint64_t semente, uint64_t jogo, uint64_t total, int bits);
+int executarLeituraSequencia(const char *caminho);
+
+// conferencia-ambiente.c
+int executarAmbiente(uint64_t semente, uint64_t total_passos, int n_ambientes, int passos_por_episodio);
+
+#endif
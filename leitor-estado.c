@@ -0,0 +1,146 @@
+// Leitor do estado publicado pelo Tetris Stack (desafio-mestre --publicar NOME)
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "estado-publicado.h"
+
+static const char *const NOMES_OPERACOES[] = {"nenhuma", "JOGAR", "RESERVAR"};
+
+/**
+ * Mapeia o segmento só para leitura. Depois disso, cada leitura é apenas uma cópia de
+ * memória: nenhuma chamada de sistema e nenhuma escrita que o jogo possa perceber.
+ */
+static const EstadoPublicado *mapearEstado(const char *nome)
+{
+    int descritor = shm_open(nome, O_RDONLY, 0);
+    if (descritor < 0)
+    {
+        perror(nome);
+        return NULL;
+    }
+
+    void *mapa = mmap(NULL, sizeof(EstadoPublicado), PROT_READ, MAP_SHARED, descritor, 0);
+    close(descritor);
+    if (mapa == MAP_FAILED)
+    {
+        perror("mmap");
+        return NULL;
+    }
+
+    const EstadoPublicado *estado = mapa;
+    if (__atomic_load_n(&estado->magico, __ATOMIC_ACQUIRE) != ESTADO_PUBLICADO_MAGICO ||
+        estado->versao != ESTADO_PUBLICADO_VERSAO)
+    {
+        fprintf(stderr, "❌ %s não é um estado publicado do Tetris Stack (versão %u).\n", nome,
+                ESTADO_PUBLICADO_VERSAO);
+        munmap(mapa, sizeof(EstadoPublicado));
+        return NULL;
+    }
+    return estado;
+}
+
+static void imprimirRetrato(const DadosPublicados *dados, uint64_t sequencia)
+{
+    printf("📡 Retrato #%llu | Semente: %llu | Jogo: %llu | Ações: %llu | Peças geradas: %llu\n",
+           (unsigned long long)(sequencia / 2), (unsigned long long)dados->semente,
+           (unsigned long long)dados->jogo, (unsigned long long)dados->acoes,
+           (unsigned long long)dados->posicao_gerador);
+
+    printf("   Fila (%d/%d):", dados->tamanho_fila, ESTADO_FILA_MAX);
+    for (int i = 0; i < dados->tamanho_fila && i < ESTADO_FILA_MAX; i++)
+    {
+        printf(" [ID:%llu|%c]", (unsigned long long)dados->fila[i].id, dados->fila[i].tipo);
+    }
+    printf("\n   Pilha (%d/%d, topo à direita):", dados->tamanho_pilha, ESTADO_PILHA_MAX);
+    for (int i = 0; i < dados->tamanho_pilha && i < ESTADO_PILHA_MAX; i++)
+    {
+        printf(" [ID:%llu|%c]", (unsigned long long)dados->pilha[i].id, dados->pilha[i].tipo);
+    }
+
+    int operacao = dados->ultima_operacao >= 0 && dados->ultima_operacao <= 2 ? dados->ultima_operacao : 0;
+    printf("\n   Última operação: %s", NOMES_OPERACOES[operacao]);
+    if (operacao != 0)
+    {
+        printf(" ([ID:%llu|%c] saiu, [ID:%llu|%c] entrou)", (unsigned long long)dados->historico_jogada.id,
+               dados->historico_jogada.tipo, (unsigned long long)dados->historico_nova.id, dados->historico_nova.tipo);
+    }
+    printf("\n   Escolhas por opção:");
+    for (int i = 0; i < ESTADO_NUM_ACOES; i++)
+    {
+        printf(" %d=%llu", i, (unsigned long long)dados->contagem_por_acao[i]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *nome = ESTADO_PUBLICADO_NOME;
+    int intervalo_ms = 200;
+    long vezes = -1; // -1 = até Ctrl+C
+
+    // Argumentos opcionais:
+    //   --nome NOME        segmento POSIX shm (padrão /tetris-stack-estado)
+    //   --intervalo MS     intervalo entre consultas
+    //   --vezes N          encerra depois de N retratos novos (1 = só o atual)
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--nome") == 0)
+        {
+            nome = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--intervalo") == 0)
+        {
+            intervalo_ms = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--vezes") == 0)
+        {
+            vezes = atol(argv[i + 1]);
+        }
+    }
+
+    const EstadoPublicado *estado = mapearEstado(nome);
+    if (estado == NULL)
+    {
+        return 1;
+    }
+
+    // Só imprime quando a sequência muda: um retrato novo a cada ação do jogador
+    uint64_t ultima_sequencia = UINT64_MAX;
+    struct timespec espera = {intervalo_ms / 1000, (long)(intervalo_ms % 1000) * 1000000L};
+    while (vezes != 0)
+    {
+        DadosPublicados dados;
+        uint64_t sequencia = lerDadosPublicados(estado, &dados, NULL);
+
+        if (sequencia != ultima_sequencia)
+        {
+            if (dados.verificador != calcularVerificador(&dados))
+            {
+                fprintf(stderr, "⚠️  Retrato #%llu com verificador inválido.\n", (unsigned long long)(sequencia / 2));
+            }
+            imprimirRetrato(&dados, sequencia);
+            fflush(stdout);
+            ultima_sequencia = sequencia;
+            if (vezes > 0)
+            {
+                vezes--;
+            }
+        }
+
+        if (vezes != 0)
+        {
+            nanosleep(&espera, NULL);
+        }
+    }
+
+    munmap((void *)estado, sizeof(EstadoPublicado));
+    return 0;
+}
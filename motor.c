@@ -0,0 +1,1141 @@
+// Motor do Tetris Stack (nível Mestre); a interface e a documentação estão em motor.h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "motor.h"
+#include "protocolo-sessoes.h"
+
+// --- 2. Variável e Função de Geração de Peças ---
+
+int tipoPecaNaPosicao(uint64_t semente, uint64_t jogo, uint64_t k)
+{
+    return tipoPorChave(chaveDoJogo(semente, jogo), k);
+}
+
+void inicializarGerador(GeradorPecas *gerador, uint64_t semente, uint64_t jogo)
+{
+    gerador->semente = semente;
+    gerador->jogo = jogo;
+    gerador->chave = chaveDoJogo(semente, jogo);
+    gerador->posicao = 0;
+    gerador->arquivo = NULL;
+}
+
+/**
+ * Pede ao kernel a próxima janela do arquivo quando a leitura de [primeira, primeira + n)
+ * cruza uma fronteira de janela: as páginas chegam antes de a leitura alcançá-las.
+ */
+static void preCarregarSequencia(const SequenciaArquivo *sequencia, uint64_t primeira, int n)
+{
+#ifdef __linux__
+    uint64_t inicio = deslocamentoNaSequencia(sequencia, primeira) / SEQUENCIA_JANELA_PRECARGA;
+    uint64_t fim = deslocamentoNaSequencia(sequencia, primeira + (uint64_t)n) / SEQUENCIA_JANELA_PRECARGA;
+    if (inicio == fim && primeira != 0)
+    {
+        return;
+    }
+
+    uint64_t dados = (uint64_t)(sequencia->palavras != NULL ? (const uint8_t *)sequencia->palavras : sequencia->bytes) -
+                     (uint64_t)sequencia->mapa;
+    uint64_t deslocamento = dados + (fim + 1) * SEQUENCIA_JANELA_PRECARGA;
+    deslocamento -= deslocamento % (uint64_t)sysconf(_SC_PAGESIZE);
+    if (deslocamento < sequencia->tamanho_mapa)
+    {
+        size_t tamanho = sequencia->tamanho_mapa - deslocamento;
+        madvise((void *)(sequencia->mapa + deslocamento),
+                tamanho < SEQUENCIA_JANELA_PRECARGA ? tamanho : SEQUENCIA_JANELA_PRECARGA, MADV_WILLNEED);
+    }
+#else
+    (void)sequencia;
+    (void)primeira;
+    (void)n;
+#endif
+}
+
+void posicionarGerador(GeradorPecas *gerador, uint64_t posicao)
+{
+    gerador->posicao = posicao;
+}
+
+// Caminho do arquivo de sequência, fora de gerarPecasLote para não pesar no gerador puro
+static __attribute__((noinline)) void lerPecasDoArquivo(GeradorPecas *gerador, Peca *destino, int n)
+{
+    uint64_t primeira = gerador->posicao;
+    preCarregarSequencia(gerador->arquivo, primeira, n);
+    for (int i = 0; i < n; i++)
+    {
+        destino[i].id = primeira + i + 1;
+        destino[i].nome[0] = TIPOS_PECA[tipoNaSequencia(gerador->arquivo, primeira + i)];
+        destino[i].nome[1] = '\0';
+    }
+    gerador->posicao += n;
+}
+
+void gerarPecasLote(GeradorPecas *gerador, Peca *destino, int n)
+{
+    uint64_t chave = gerador->chave;
+    uint64_t primeira = gerador->posicao;
+
+    if (gerador->arquivo != NULL)
+    {
+        lerPecasDoArquivo(gerador, destino, n);
+        return;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        destino[i].id = primeira + i + 1;
+        destino[i].nome[0] = TIPOS_PECA[tipoPorChave(chave, primeira + i)];
+        destino[i].nome[1] = '\0';
+    }
+
+    gerador->posicao += n;
+}
+
+Peca gerarPeca(GeradorPecas *gerador)
+{
+    Peca nova_peca;
+    if (gerador->arquivo != NULL)
+    {
+        lerPecasDoArquivo(gerador, &nova_peca, 1);
+        return nova_peca;
+    }
+
+    uint64_t k = gerador->posicao++;
+    nova_peca.id = k + 1;
+    nova_peca.nome[0] = TIPOS_PECA[tipoPorChave(gerador->chave, k)];
+    nova_peca.nome[1] = '\0';
+    return nova_peca;
+}
+
+// --- 3. Funções da FILA CIRCULAR ---
+
+void inicializarFila(FilaCircular *fila)
+{
+    fila->frente = 0;
+    fila->traseira = 0;
+    fila->tamanho = 0;
+}
+
+int filaCheia(const FilaCircular *fila)
+{
+    return fila->tamanho == CAPACIDADE_FILA;
+}
+
+int filaVazia(const FilaCircular *fila)
+{
+    return fila->tamanho == 0;
+}
+
+int enfileirar(FilaCircular *fila, Peca peca)
+{
+    if (filaCheia(fila))
+    {
+        return 0;
+    }
+    fila->itens[fila->traseira] = peca;
+    fila->traseira = (fila->traseira + 1) % CAPACIDADE_FILA;
+    fila->tamanho++;
+    return 1;
+}
+
+int desenfileirar(FilaCircular *fila, Peca *destino)
+{
+    if (filaVazia(fila))
+    {
+        return 0;
+    }
+    *destino = fila->itens[fila->frente];
+    fila->frente = (fila->frente + 1) % CAPACIDADE_FILA;
+    fila->tamanho--;
+    return 1;
+}
+
+int enfileirarLote(FilaCircular *fila, const Peca *pecas, int n)
+{
+    int livres = CAPACIDADE_FILA - fila->tamanho;
+    if (n > livres)
+    {
+        n = livres;
+    }
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    int ate_o_fim = CAPACIDADE_FILA - fila->traseira;
+    int primeiro_bloco = n < ate_o_fim ? n : ate_o_fim;
+    memcpy(&fila->itens[fila->traseira], pecas, primeiro_bloco * sizeof(Peca));
+    memcpy(&fila->itens[0], pecas + primeiro_bloco, (n - primeiro_bloco) * sizeof(Peca));
+
+    fila->traseira = (fila->traseira + n) % CAPACIDADE_FILA;
+    fila->tamanho += n;
+    return n;
+}
+
+int desenfileirarLote(FilaCircular *fila, Peca *destino, int n)
+{
+    if (n > fila->tamanho)
+    {
+        n = fila->tamanho;
+    }
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    int ate_o_fim = CAPACIDADE_FILA - fila->frente;
+    int primeiro_bloco = n < ate_o_fim ? n : ate_o_fim;
+    memcpy(destino, &fila->itens[fila->frente], primeiro_bloco * sizeof(Peca));
+    memcpy(destino + primeiro_bloco, &fila->itens[0], (n - primeiro_bloco) * sizeof(Peca));
+
+    fila->frente = (fila->frente + n) % CAPACIDADE_FILA;
+    fila->tamanho -= n;
+    return n;
+}
+
+const Peca *espiarFila(const FilaCircular *fila)
+{
+    if (filaVazia(fila))
+    {
+        return NULL;
+    }
+    return &fila->itens[fila->frente];
+}
+
+int obterIndiceAnteriorFrente(const FilaCircular *fila)
+{
+    return (fila->frente - 1 + CAPACIDADE_FILA) % CAPACIDADE_FILA;
+}
+
+int obterIndiceAnteriorTraseira(const FilaCircular *fila)
+{
+    return (fila->traseira - 1 + CAPACIDADE_FILA) % CAPACIDADE_FILA;
+}
+
+// --- 4. Funções da PILHA LINEAR ---
+
+void inicializarPilha(Pilha *pilha)
+{
+    pilha->topo = -1;
+}
+
+int pilhaCheia(const Pilha *pilha)
+{
+    return pilha->topo == CAPACIDADE_PILHA - 1;
+}
+
+int pilhaVazia(const Pilha *pilha)
+{
+    return pilha->topo == -1;
+}
+
+int empilhar(Pilha *pilha, Peca peca)
+{
+    if (pilhaCheia(pilha))
+    {
+        return 0;
+    }
+    pilha->topo++;
+    pilha->itens[pilha->topo] = peca;
+    return 1;
+}
+
+int desempilhar(Pilha *pilha, Peca *destino)
+{
+    if (pilhaVazia(pilha))
+    {
+        return 0;
+    }
+    *destino = pilha->itens[pilha->topo];
+    pilha->topo--;
+    return 1;
+}
+
+int empilharLote(Pilha *pilha, const Peca *pecas, int n)
+{
+    int livres = CAPACIDADE_PILHA - 1 - pilha->topo;
+    if (n > livres)
+    {
+        n = livres;
+    }
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        pilha->itens[pilha->topo + n - i] = pecas[i];
+    }
+    pilha->topo += n;
+    return n;
+}
+
+int desempilharLote(Pilha *pilha, Peca *destino, int n)
+{
+    if (n > pilha->topo + 1)
+    {
+        n = pilha->topo + 1;
+    }
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        destino[i] = pilha->itens[pilha->topo - i];
+    }
+    pilha->topo -= n;
+    return n;
+}
+
+const Peca *espiarPilha(const Pilha *pilha)
+{
+    if (pilhaVazia(pilha))
+    {
+        return NULL;
+    }
+    return &pilha->itens[pilha->topo];
+}
+
+// --- 5. Funções de Visualização e Inicialização ---
+
+void escreverSaida(Saida *saida, const char *formato, ...)
+{
+    va_list argumentos;
+    va_start(argumentos, formato);
+    if (saida->arquivo != NULL)
+    {
+        vfprintf(saida->arquivo, formato, argumentos);
+    }
+    else if (saida->tamanho < saida->capacidade)
+    {
+        int escritos = vsnprintf(saida->buffer + saida->tamanho, saida->capacidade - saida->tamanho, formato, argumentos);
+        if (escritos > 0)
+        {
+            // Texto truncado ocupa o buffer até o fim (sem o terminador)
+            size_t livres = saida->capacidade - saida->tamanho;
+            saida->tamanho += (size_t)escritos < livres ? (size_t)escritos : livres - 1;
+        }
+    }
+    va_end(argumentos);
+}
+
+void escreverFila(Saida *saida, const FilaCircular *fila)
+{
+    escreverSaida(saida, "\n Fila de Peças Futuras (Tamanho: %d/%d) \n", fila->tamanho, CAPACIDADE_FILA);
+
+    if (filaVazia(fila))
+    {
+        escreverSaida(saida, " A fila está vazia.\n");
+        return;
+    }
+
+    int i = fila->frente;
+    int count = 0;
+    escreverSaida(saida, " Frente (Próxima) -> ");
+
+    while (count < fila->tamanho)
+    {
+        escreverSaida(saida, "[ID:%llu|%s]", (unsigned long long)fila->itens[i].id, fila->itens[i].nome);
+
+        if (count < fila->tamanho - 1)
+        {
+            escreverSaida(saida, " -> ");
+        }
+
+        i = (i + 1) % CAPACIDADE_FILA;
+        count++;
+    }
+
+    escreverSaida(saida, " <- Traseira\n");
+    escreverSaida(saida, "---------------------------------------------------\n");
+}
+
+void escreverPilha(Saida *saida, const Pilha *pilha)
+{
+    escreverSaida(saida, "\n🔋 Pilha de Reserva (Tamanho: %d/%d) \n", pilha->topo + 1, CAPACIDADE_PILHA);
+
+    if (pilhaVazia(pilha))
+    {
+        escreverSaida(saida, " A pilha de reserva está vazia.\n");
+        escreverSaida(saida, "---------------------------------------------------\n");
+        return;
+    }
+
+    escreverSaida(saida, " Topo (Peça Reservada) -> ");
+    for (int i = pilha->topo; i >= 0; i--)
+    {
+        escreverSaida(saida, "[ID:%llu|%s]", (unsigned long long)pilha->itens[i].id, pilha->itens[i].nome);
+
+        if (i > 0)
+        {
+            escreverSaida(saida, " | ");
+        }
+    }
+    escreverSaida(saida, " <- Base\n");
+    escreverSaida(saida, "---------------------------------------------------\n");
+}
+
+void visualizarFila(const FilaCircular *fila)
+{
+    Saida terminal = {stdout, NULL, 0, 0};
+    escreverFila(&terminal, fila);
+}
+
+void visualizarPilha(const Pilha *pilha)
+{
+    Saida terminal = {stdout, NULL, 0, 0};
+    escreverPilha(&terminal, pilha);
+}
+
+void inicializarFilaAutomatica(FilaCircular *fila, GeradorPecas *gerador)
+{
+    Peca novas[CAPACIDADE_FILA];
+    int faltando = CAPACIDADE_FILA - fila->tamanho;
+    gerarPecasLote(gerador, novas, faltando);
+    enfileirarLote(fila, novas, faltando);
+}
+
+// --- Janela de Prévia Preguiçosa ---
+
+void inicializarJanelaPrevia(JanelaPrevia *janela, uint64_t semente, uint64_t jogo, uint64_t profundidade)
+{
+    inicializarFila(&janela->devolvidas);
+    inicializarGerador(&janela->gerador, semente, jogo);
+    janela->profundidade = profundidade;
+}
+
+int espiarJanelaPrevia(const JanelaPrevia *janela, uint64_t i, Peca *destino)
+{
+    if (i >= janela->profundidade)
+    {
+        return 0;
+    }
+
+    const FilaCircular *devolvidas = &janela->devolvidas;
+    if (i < (uint64_t)devolvidas->tamanho)
+    {
+        *destino = devolvidas->itens[(devolvidas->frente + i) % CAPACIDADE_FILA];
+        return 1;
+    }
+
+    uint64_t posicao = janela->gerador.posicao + (i - devolvidas->tamanho);
+    destino->id = posicao + 1;
+    destino->nome[0] = TIPOS_PECA[tipoDoGerador(&janela->gerador, posicao)];
+    destino->nome[1] = '\0';
+    return 1;
+}
+
+void retirarDaJanelaPrevia(JanelaPrevia *janela, Peca *destino)
+{
+    if (!desenfileirar(&janela->devolvidas, destino))
+    {
+        *destino = gerarPeca(&janela->gerador);
+    }
+}
+
+int devolverAJanelaPrevia(JanelaPrevia *janela, Peca peca)
+{
+    FilaCircular *devolvidas = &janela->devolvidas;
+    if (filaCheia(devolvidas))
+    {
+        return 0;
+    }
+    devolvidas->frente = obterIndiceAnteriorFrente(devolvidas);
+    devolvidas->tamanho++;
+    devolvidas->itens[devolvidas->frente] = peca;
+    return 1;
+}
+
+// --- 6. Motor do Jogo e Funções Estratégicas do Nível Mestre ---
+
+void inicializarJogoComGerador(Jogo *jogo, const GeradorPecas *gerador)
+{
+    jogo->gerador = *gerador;
+    inicializarFila(&jogo->fila);
+    inicializarFilaAutomatica(&jogo->fila, &jogo->gerador); // Fila cheia com 5 peças
+    inicializarPilha(&jogo->pilha);
+
+    // Id 0 nunca é gerado: marca o histórico como vazio
+    Peca nenhuma = {0, ""};
+    jogo->ultima_operacao = OP_NENHUMA;
+    jogo->peca_historico_jogada = nenhuma;
+    jogo->peca_historico_nova = nenhuma;
+}
+
+void inicializarJogo(Jogo *jogo, uint64_t semente, uint64_t numero_jogo)
+{
+    GeradorPecas gerador;
+    inicializarGerador(&gerador, semente, numero_jogo);
+    inicializarJogoComGerador(jogo, &gerador);
+}
+
+Peca espiarPreviaJogo(const Jogo *jogo, uint64_t i)
+{
+    const FilaCircular *fila = &jogo->fila;
+    if (i < (uint64_t)fila->tamanho)
+    {
+        return fila->itens[(fila->frente + i) % CAPACIDADE_FILA];
+    }
+
+    uint64_t posicao = jogo->gerador.posicao + (i - fila->tamanho);
+    Peca peca;
+    peca.id = posicao + 1;
+    peca.nome[0] = TIPOS_PECA[tipoDoGerador(&jogo->gerador, posicao)];
+    peca.nome[1] = '\0';
+    return peca;
+}
+
+ResultadoOperacao jogarPeca(Jogo *jogo)
+{
+    if (!desenfileirar(&jogo->fila, &jogo->peca_historico_jogada))
+    {
+        jogo->ultima_operacao = OP_NENHUMA;
+        return RESULTADO_FILA_VAZIA;
+    }
+
+    jogo->peca_historico_nova = gerarPeca(&jogo->gerador);
+    enfileirar(&jogo->fila, jogo->peca_historico_nova);
+
+    jogo->ultima_operacao = OP_JOGAR;
+    return RESULTADO_OK;
+}
+
+ResultadoOperacao reservarPeca(Jogo *jogo)
+{
+    if (pilhaCheia(&jogo->pilha))
+    {
+        jogo->ultima_operacao = OP_NENHUMA;
+        return RESULTADO_PILHA_CHEIA;
+    }
+    if (!desenfileirar(&jogo->fila, &jogo->peca_historico_jogada))
+    {
+        jogo->ultima_operacao = OP_NENHUMA;
+        return RESULTADO_FILA_VAZIA;
+    }
+
+    empilhar(&jogo->pilha, jogo->peca_historico_jogada);
+
+    jogo->peca_historico_nova = gerarPeca(&jogo->gerador);
+    enfileirar(&jogo->fila, jogo->peca_historico_nova);
+
+    jogo->ultima_operacao = OP_RESERVAR;
+    return RESULTADO_OK;
+}
+
+ResultadoOperacao usarPecaReservada(Jogo *jogo, Peca *peca_usada)
+{
+    if (!desempilhar(&jogo->pilha, peca_usada))
+    {
+        return RESULTADO_PILHA_VAZIA;
+    }
+
+    jogo->ultima_operacao = OP_NENHUMA;
+    return RESULTADO_OK;
+}
+
+ResultadoOperacao trocarPilhaFila(Jogo *jogo)
+{
+    FilaCircular *fila = &jogo->fila;
+    Pilha *pilha = &jogo->pilha;
+
+    if (filaVazia(fila))
+    {
+        return RESULTADO_FILA_VAZIA;
+    }
+    if (pilhaVazia(pilha))
+    {
+        return RESULTADO_PILHA_VAZIA;
+    }
+
+    Peca temp = fila->itens[fila->frente];
+    fila->itens[fila->frente] = pilha->itens[pilha->topo];
+    pilha->itens[pilha->topo] = temp;
+
+    // Resetar histórico
+    jogo->ultima_operacao = OP_NENHUMA;
+    return RESULTADO_OK;
+}
+
+ResultadoOperacao desfazerUltimaJogada(Jogo *jogo)
+{
+    FilaCircular *fila = &jogo->fila;
+    Pilha *pilha = &jogo->pilha;
+
+    if (jogo->ultima_operacao == OP_NENHUMA)
+    {
+        return RESULTADO_SEM_HISTORICO;
+    }
+
+    // 1. Desfaz o último ENQUEUE (remoção da peça nova gerada)
+    // A última peça inserida é sempre no índice anterior à traseira; só é removida
+    // se o Enqueue realmente aconteceu, para não corromper o tamanho da fila.
+    if (fila->tamanho > 0 && fila->itens[obterIndiceAnteriorTraseira(fila)].id == jogo->peca_historico_nova.id)
+    {
+        fila->traseira = obterIndiceAnteriorTraseira(fila); // Volta a traseira
+        fila->tamanho--;                                    // Decrementa o tamanho
+        jogo->gerador.posicao--;                            // A mesma peça será gerada de novo
+    }
+
+    // 2. Reverte o Dequeue: A peça jogada/reservada volta para a frente da Fila
+    if (!filaCheia(fila))
+    {
+        fila->frente = obterIndiceAnteriorFrente(fila); // Volta a frente
+        fila->tamanho++;                                // Incrementa o tamanho
+        fila->itens[fila->frente] = jogo->peca_historico_jogada;
+    }
+
+    // 3. Reverte o PUSH na Pilha: A peça que entrou na pilha deve ser removida
+    if (jogo->ultima_operacao == OP_RESERVAR && !pilhaVazia(pilha) &&
+        pilha->itens[pilha->topo].id == jogo->peca_historico_jogada.id)
+    {
+        pilha->topo--;
+    }
+
+    // Resetar o histórico após o desfazer
+    jogo->ultima_operacao = OP_NENHUMA;
+    return RESULTADO_OK;
+}
+
+ResultadoOperacao inverterFilaComPilha(Jogo *jogo)
+{
+    FilaCircular *fila = &jogo->fila;
+    Pilha *pilha = &jogo->pilha;
+    Peca pecas_fila[CAPACIDADE_FILA];
+    Peca pecas_pilha[CAPACIDADE_PILHA];
+
+    // 1. Esvazia as duas estruturas de uma vez (fila na ordem de saída, pilha do topo para a base)
+    int total_fila = desenfileirarLote(fila, pecas_fila, CAPACIDADE_FILA);
+    int total_pilha = desempilharLote(pilha, pecas_pilha, CAPACIDADE_PILHA);
+
+    // 2. Frente da fila -> Pilha (pecas_fila[0] fica no topo)
+    int para_pilha = total_fila < CAPACIDADE_PILHA ? total_fila : CAPACIDADE_PILHA;
+    empilharLote(pilha, pecas_fila, para_pilha);
+
+    // 3. Pilha -> frente da Fila, seguida das peças da fila que não couberam na pilha
+    enfileirarLote(fila, pecas_pilha, total_pilha);
+    enfileirarLote(fila, pecas_fila + para_pilha, total_fila - para_pilha);
+
+    // 4. Mantém a fila sempre cheia, repondo com peças novas
+    inicializarFilaAutomatica(fila, &jogo->gerador);
+
+    // Resetar histórico
+    jogo->ultima_operacao = OP_NENHUMA;
+    return RESULTADO_OK;
+}
+
+ResultadoOperacao executarAcao(Jogo *jogo, Acao acao)
+{
+    Peca peca_usada;
+
+    switch (acao)
+    {
+    case ACAO_JOGAR:
+        return jogarPeca(jogo);
+    case ACAO_RESERVAR:
+        return reservarPeca(jogo);
+    case ACAO_USAR:
+        return usarPecaReservada(jogo, &peca_usada);
+    case ACAO_TROCAR:
+        return trocarPilhaFila(jogo);
+    case ACAO_DESFAZER:
+        return desfazerUltimaJogada(jogo);
+    case ACAO_INVERTER:
+        return inverterFilaComPilha(jogo);
+    default:
+        return RESULTADO_OK;
+    }
+}
+
+// --- Histórico Compacto (desfazer em vários níveis) ---
+
+/*
+ * Cada operação bem-sucedida vira um registro de 1 byte na maioria dos casos. O byte de
+ * operação (sempre < 0x80) fica no FIM do registro: os 3 bits baixos guardam a Acao e os 4
+ * bits altos um campo pequeno; se o campo não couber (>= 15), o valor - 15 vai num varint
+ * logo antes do byte de operação.
+ *
+ * As peças não são copiadas: a peça nova de uma jogada é sempre a de id = gerador.posicao e
+ * o tipo de qualquer peça sai do gerador pelo id, então basta guardar a distância entre o id
+ * e a posição do gerador (quase sempre o tamanho da fila). Varints terminam em um byte < 0x80
+ * e bytes de operação também são < 0x80, o que permite ler o histórico de trás para frente.
+ */
+
+int criarHistorico(HistoricoCompacto *historico, size_t capacidade)
+{
+    historico->bytes = malloc(capacidade > 16 ? capacidade : 16);
+    historico->tamanho = 0;
+    historico->capacidade = historico->bytes ? (capacidade > 16 ? capacidade : 16) : 0;
+    historico->operacoes = 0;
+    return historico->bytes != NULL;
+}
+
+void liberarHistorico(HistoricoCompacto *historico)
+{
+    free(historico->bytes);
+    historico->bytes = NULL;
+    historico->tamanho = historico->capacidade = 0;
+    historico->operacoes = 0;
+}
+
+// Acrescenta um registro; retorna 0 se não houver memória para crescer o buffer
+static int registrarOperacao(HistoricoCompacto *historico, Acao acao, uint64_t valor)
+{
+    // Pior caso: varint de 10 bytes + byte de operação
+    if (historico->capacidade - historico->tamanho < 11)
+    {
+        uint8_t *maior = realloc(historico->bytes, historico->capacidade * 2);
+        if (maior == NULL)
+        {
+            return 0;
+        }
+        historico->bytes = maior;
+        historico->capacidade *= 2;
+    }
+
+    uint64_t campo = valor < CAMPO_ESTENDIDO ? valor : CAMPO_ESTENDIDO;
+    if (campo == CAMPO_ESTENDIDO)
+    {
+        uint64_t resto = valor - CAMPO_ESTENDIDO;
+        while (resto >= 0x80)
+        {
+            historico->bytes[historico->tamanho++] = (uint8_t)(resto | 0x80);
+            resto >>= 7;
+        }
+        historico->bytes[historico->tamanho++] = (uint8_t)resto;
+    }
+    historico->bytes[historico->tamanho++] = (uint8_t)(acao | (campo << 3));
+    historico->operacoes++;
+    return 1;
+}
+
+// Retira o último registro, devolvendo a ação e o valor do campo
+static Acao retirarOperacao(HistoricoCompacto *historico, uint64_t *valor)
+{
+    uint8_t operacao = historico->bytes[--historico->tamanho];
+    *valor = operacao >> 3;
+
+    if (*valor == CAMPO_ESTENDIDO)
+    {
+        // O último byte do varint é < 0x80; os anteriores têm o bit de continuação ligado
+        size_t fim = historico->tamanho;
+        size_t inicio = fim - 1;
+        while (inicio > 0 && (historico->bytes[inicio - 1] & 0x80))
+        {
+            inicio--;
+        }
+
+        uint64_t resto = 0;
+        for (size_t i = fim; i > inicio; i--)
+        {
+            resto = (resto << 7) | (historico->bytes[i - 1] & 0x7F);
+        }
+        *valor += resto;
+        historico->tamanho = inicio;
+    }
+
+    historico->operacoes--;
+    return (Acao)(operacao & 0x7);
+}
+
+// Reconstrói uma peça a partir do id (o tipo vem do gerador da partida)
+static Peca pecaPorId(const GeradorPecas *gerador, uint64_t id)
+{
+    Peca peca;
+    peca.id = id;
+    peca.nome[0] = TIPOS_PECA[tipoDoGerador(gerador, id - 1)];
+    peca.nome[1] = '\0';
+    return peca;
+}
+
+// Desfaz a última inserção na traseira (peça nova) e devolve a peça ao gerador
+static void removerPecaNova(Jogo *jogo)
+{
+    jogo->fila.traseira = obterIndiceAnteriorTraseira(&jogo->fila);
+    jogo->fila.tamanho--;
+    jogo->gerador.posicao--;
+}
+
+static void devolverAFrente(FilaCircular *fila, Peca peca)
+{
+    fila->frente = obterIndiceAnteriorFrente(fila);
+    fila->tamanho++;
+    fila->itens[fila->frente] = peca;
+}
+
+ResultadoOperacao executarAcaoComHistorico(Jogo *jogo, HistoricoCompacto *historico, Acao acao)
+{
+    ResultadoOperacao resultado;
+    uint64_t valor = 0;
+
+    switch (acao)
+    {
+    case ACAO_DESFAZER:
+        return desfazerPeloHistorico(jogo, historico);
+    case ACAO_USAR:
+    {
+        Peca peca_usada;
+        resultado = usarPecaReservada(jogo, &peca_usada);
+        if (resultado == RESULTADO_OK)
+        {
+            valor = jogo->gerador.posicao - peca_usada.id;
+        }
+        break;
+    }
+    case ACAO_INVERTER:
+    {
+        // Guarda quantas peças estavam na pilha e quantas peças novas foram geradas
+        uint64_t na_pilha = (uint64_t)(jogo->pilha.topo + 1);
+        uint64_t posicao_antes = jogo->gerador.posicao;
+        resultado = inverterFilaComPilha(jogo);
+        valor = na_pilha | ((jogo->gerador.posicao - posicao_antes) << 2);
+        break;
+    }
+    default:
+        resultado = executarAcao(jogo, acao);
+        if (acao == ACAO_JOGAR)
+        {
+            valor = jogo->gerador.posicao - jogo->peca_historico_jogada.id;
+        }
+        break;
+    }
+
+    // Só as ações que mudam a partida entram no histórico. Sair, Visualizar e valores fora do
+    // menu não fazem nada no motor, e uma Acao >= 8 invadiria os bits do campo no registro
+    int altera_partida = acao >= ACAO_JOGAR && acao <= ACAO_INVERTER;
+    if (resultado == RESULTADO_OK && altera_partida && !registrarOperacao(historico, acao, valor))
+    {
+        // Sem memória para o registro: a operação continua valendo, mas o histórico é descartado
+        historico->tamanho = 0;
+        historico->operacoes = 0;
+    }
+    return resultado;
+}
+
+ResultadoOperacao desfazerPeloHistorico(Jogo *jogo, HistoricoCompacto *historico)
+{
+    if (historico->operacoes == 0)
+    {
+        return RESULTADO_SEM_HISTORICO;
+    }
+
+    uint64_t valor;
+    Acao acao = retirarOperacao(historico, &valor);
+    FilaCircular *fila = &jogo->fila;
+    Pilha *pilha = &jogo->pilha;
+
+    switch (acao)
+    {
+    case ACAO_JOGAR:
+    {
+        uint64_t id_jogada = jogo->gerador.posicao - valor;
+        removerPecaNova(jogo);
+        devolverAFrente(fila, pecaPorId(&jogo->gerador, id_jogada));
+        break;
+    }
+    case ACAO_RESERVAR:
+    {
+        Peca reservada;
+        removerPecaNova(jogo);
+        desempilhar(pilha, &reservada);
+        devolverAFrente(fila, reservada);
+        break;
+    }
+    case ACAO_USAR:
+        empilhar(pilha, pecaPorId(&jogo->gerador, jogo->gerador.posicao - valor));
+        break;
+    case ACAO_TROCAR:
+        trocarPilhaFila(jogo); // A troca é a sua própria inversa
+        break;
+    case ACAO_INVERTER:
+    {
+        int na_pilha = (int)(valor & 0x3);
+        int geradas = (int)(valor >> 2);
+        Peca pecas_fila[CAPACIDADE_FILA];
+        Peca pecas_pilha[CAPACIDADE_PILHA] = {0}; // Zerada só para o -Wmaybe-uninitialized do build PGO
+
+        fila->traseira = (fila->traseira - geradas + CAPACIDADE_FILA) % CAPACIDADE_FILA;
+        fila->tamanho -= geradas;
+        jogo->gerador.posicao -= geradas;
+
+        // Fila = [antiga pilha, do topo para a base][sobras da antiga fila]; pilha = antiga frente da fila
+        int total_fila = desenfileirarLote(fila, pecas_fila, CAPACIDADE_FILA);
+        int total_pilha = desempilharLote(pilha, pecas_pilha, CAPACIDADE_PILHA);
+        enfileirarLote(fila, pecas_pilha, total_pilha);
+        enfileirarLote(fila, pecas_fila + na_pilha, total_fila - na_pilha);
+        empilharLote(pilha, pecas_fila, na_pilha);
+        break;
+    }
+    default:
+        break;
+    }
+
+    jogo->ultima_operacao = OP_NENHUMA;
+    return RESULTADO_OK;
+}
+
+// --- Arquivos de Sequência Mapeados ---
+
+#ifdef __linux__
+int abrirSequenciaArquivo(SequenciaArquivo *sequencia, const char *caminho)
+{
+    int descritor = open(caminho, O_RDONLY | O_CLOEXEC);
+    if (descritor < 0)
+    {
+        perror(caminho);
+        return 0;
+    }
+
+    struct stat informacoes;
+    if (fstat(descritor, &informacoes) != 0 || (size_t)informacoes.st_size < sizeof(CabecalhoSequencia))
+    {
+        printf("❌ %s não tem nem o cabeçalho de uma sequência.\n", caminho);
+        close(descritor);
+        return 0;
+    }
+
+    void *mapa = mmap(NULL, (size_t)informacoes.st_size, PROT_READ, MAP_SHARED, descritor, 0);
+    close(descritor);
+    if (mapa == MAP_FAILED)
+    {
+        perror("mmap");
+        return 0;
+    }
+
+    // Quantas peças cabem nos bytes depois do cabeçalho. O total declarado é comparado com essa
+    // capacidade, sem somar nada a ele: um total perto de 2^64 não pode dar a volta e passar
+    const CabecalhoSequencia *cabecalho = mapa;
+    uint64_t bytes_dados = (uint64_t)informacoes.st_size - sizeof(CabecalhoSequencia);
+    uint64_t capacidade = 0;
+    if (cabecalho->bits_por_peca == 3)
+    {
+        capacidade = bytes_dados / sizeof(uint64_t) * SEQUENCIA_PECAS_POR_PALAVRA;
+    }
+    else if (cabecalho->bits_por_peca == 8)
+    {
+        capacidade = bytes_dados;
+    }
+
+    if (cabecalho->magico != SEQUENCIA_MAGICO || cabecalho->versao != SEQUENCIA_VERSAO || capacidade == 0 ||
+        cabecalho->total_pecas == 0 || cabecalho->total_pecas > capacidade)
+    {
+        printf("❌ %s não é uma sequência de peças válida (versão %u, 3 ou 8 bits por peça).\n", caminho,
+               SEQUENCIA_VERSAO);
+        munmap(mapa, (size_t)informacoes.st_size);
+        return 0;
+    }
+
+    // A leitura é sequencial: o kernel pode ler bem à frente e liberar o que ficou para trás
+    madvise(mapa, (size_t)informacoes.st_size, MADV_SEQUENTIAL);
+
+    sequencia->mapa = mapa;
+    sequencia->tamanho_mapa = (size_t)informacoes.st_size;
+    sequencia->bytes = cabecalho->bits_por_peca == 8 ? sequencia->mapa + sizeof(CabecalhoSequencia) : NULL;
+    sequencia->palavras =
+        cabecalho->bits_por_peca == 3 ? (const uint64_t *)(sequencia->mapa + sizeof(CabecalhoSequencia)) : NULL;
+    sequencia->total_pecas = cabecalho->total_pecas;
+    sequencia->chave_continuacao = chaveDoJogo(cabecalho->semente, cabecalho->jogo);
+    return 1;
+}
+
+void fecharSequenciaArquivo(SequenciaArquivo *sequencia)
+{
+    if (sequencia->mapa != NULL)
+    {
+        munmap((void *)sequencia->mapa, sequencia->tamanho_mapa);
+        sequencia->mapa = NULL;
+    }
+}
+
+void inicializarGeradorComArquivo(GeradorPecas *gerador, const SequenciaArquivo *sequencia)
+{
+    const CabecalhoSequencia *cabecalho = (const CabecalhoSequencia *)sequencia->mapa;
+    inicializarGerador(gerador, cabecalho->semente, cabecalho->jogo);
+    gerador->arquivo = sequencia;
+}
+#else
+int abrirSequenciaArquivo(SequenciaArquivo *sequencia, const char *caminho)
+{
+    (void)sequencia;
+    printf("❌ Arquivos de sequência (%s) usam mmap e só estão disponíveis no Linux.\n", caminho);
+    return 0;
+}
+
+void fecharSequenciaArquivo(SequenciaArquivo *sequencia)
+{
+    (void)sequencia;
+}
+
+void inicializarGeradorComArquivo(GeradorPecas *gerador, const SequenciaArquivo *sequencia)
+{
+    (void)sequencia;
+    inicializarGerador(gerador, 0, 0);
+}
+#endif
+
+// --- Menu Estratégico (texto compartilhado pelo terminal e pelas sessões do servidor) ---
+
+void exibirMenu(Saida *saida)
+{
+    escreverSaida(saida, "\n--- 🧠 Menu Estratégico ---\n");
+    escreverSaida(saida, "\n1. Jogar a Próxima Peça (Dequeue + Novo Enqueue)\n");
+    escreverSaida(saida, "2. Reservar Peça (Dequeue da Fila -> PUSH na Pilha)\n");
+    escreverSaida(saida, "3. Usar Peça Reservada (POP da Pilha)\n");
+    escreverSaida(saida, "4. Trocar Peça (Topo da Pilha <-> Frente da Fila)\n");
+    escreverSaida(saida, "5. Desfazer Última Jogada/Reserva\n");
+    escreverSaida(saida, "6. Inverter Fila com Pilha\n");
+    escreverSaida(saida, "7. Visualizar Ambos\n");
+    escreverSaida(saida, "0. Sair do Programa\n");
+    escreverSaida(saida, "%s", PROMPT_MENU);
+}
+
+void exibirBoasVindas(Saida *saida, const Jogo *jogo)
+{
+    escreverSaida(saida, "👑 Bem-vindo ao Tetris Stack: Nível MESTRE! 👑\n");
+    escreverSaida(saida, "Sistema de Integração Total com Estratégia Inicializado.\n");
+    escreverSaida(saida, "Semente: %llu | Jogo: %llu\n", (unsigned long long)jogo->gerador.semente,
+                  (unsigned long long)jogo->gerador.jogo);
+    escreverFila(saida, &jogo->fila);
+    escreverPilha(saida, &jogo->pilha);
+}
+
+void processarOpcaoMenu(Jogo *jogo, int opcao, Saida *saida)
+{
+    switch (opcao)
+    {
+    case ACAO_JOGAR:
+    { // Jogar (Dequeue e Novo Enqueue)
+        if (jogarPeca(jogo) == RESULTADO_OK)
+        {
+            escreverSaida(saida, "\n🚀 Peça Jogada: [ID:%llu|%s].\n", (unsigned long long)jogo->peca_historico_jogada.id, jogo->peca_historico_jogada.nome);
+            escreverSaida(saida, "➕ Nova Peça Inserida na Fila: [ID:%llu|%s].\n", (unsigned long long)jogo->peca_historico_nova.id, jogo->peca_historico_nova.nome);
+        }
+        else
+        {
+            escreverSaida(saida, "\n❌ Fila vazia! Não é possível jogar.\n");
+        }
+        break;
+    }
+    case ACAO_RESERVAR:
+    { // Reservar (Dequeue -> PUSH)
+        ResultadoOperacao resultado = reservarPeca(jogo);
+        if (resultado == RESULTADO_OK)
+        {
+            escreverSaida(saida, "\n📦 Peça Reservada: [ID:%llu|%s] movida da Fila para a Pilha.\n", (unsigned long long)jogo->peca_historico_jogada.id, jogo->peca_historico_jogada.nome);
+            escreverSaida(saida, "➕ Nova Peça Inserida na Fila: [ID:%llu|%s].\n", (unsigned long long)jogo->peca_historico_nova.id, jogo->peca_historico_nova.nome);
+        }
+        else if (resultado == RESULTADO_PILHA_CHEIA)
+        {
+            escreverSaida(saida, "\n❌ Pilha de Reserva cheia! Não é possível reservar mais peças.\n");
+        }
+        else
+        {
+            escreverSaida(saida, "\n❌ Fila vazia! Não há peças para reservar.\n");
+        }
+        break;
+    }
+    case ACAO_USAR:
+    { // Usar Peça Reservada (POP)
+        Peca peca_usada;
+        if (usarPecaReservada(jogo, &peca_usada) == RESULTADO_OK)
+        {
+            escreverSaida(saida, "\n✅ Peça Reservada Usada: [ID:%llu|%s] removida da Pilha (POP).\n", (unsigned long long)peca_usada.id, peca_usada.nome);
+        }
+        else
+        {
+            escreverSaida(saida, "\n❌ Pilha de Reserva vazia! Nenhuma peça para usar.\n");
+        }
+        break;
+    }
+    case ACAO_TROCAR:
+    { // Trocar Peça (Topo da Pilha <-> Frente da Fila)
+        if (trocarPilhaFila(jogo) == RESULTADO_OK)
+        {
+            const Peca *frente = espiarFila(&jogo->fila);
+            const Peca *topo = espiarPilha(&jogo->pilha);
+            escreverSaida(saida, "\n🔄 Troca Realizada:\n");
+            escreverSaida(saida, "   Fila (Frente): [ID:%llu|%s] <- Novo\n", (unsigned long long)frente->id, frente->nome);
+            escreverSaida(saida, "   Pilha (Topo): [ID:%llu|%s] <- Novo\n", (unsigned long long)topo->id, topo->nome);
+        }
+        else
+        {
+            escreverSaida(saida, "❌ Erro: Uma das estruturas está vazia. Não é possível trocar.\n");
+        }
+        break;
+    }
+    case ACAO_DESFAZER:
+    { // Desfazer Última Jogada
+        // Guarda o histórico antes de desfazer, para exibir o que foi revertido
+        TipoOperacao desfeita = jogo->ultima_operacao;
+        Peca jogada = jogo->peca_historico_jogada;
+        Peca nova = jogo->peca_historico_nova;
+
+        if (desfazerUltimaJogada(jogo) == RESULTADO_OK)
+        {
+            escreverSaida(saida, "\n⏪ Desfazendo a última operação (%s)...\n", desfeita == OP_JOGAR ? "JOGAR" : "RESERVAR");
+            escreverSaida(saida, "   - [ID:%llu|%s] (Nova Peça) removida da Traseira da Fila.\n", (unsigned long long)nova.id, nova.nome);
+            escreverSaida(saida, "   - [ID:%llu|%s] (%s) restaurada na Frente da Fila.\n", (unsigned long long)jogada.id, jogada.nome,
+                   desfeita == OP_JOGAR ? "Peça Jogada" : "Peça Reservada");
+            if (desfeita == OP_RESERVAR)
+            {
+                escreverSaida(saida, "   - A peça (PUSH) foi removida da Pilha de Reserva.\n");
+            }
+        }
+        else
+        {
+            escreverSaida(saida, "\n❌ Não há nenhuma operação recente (Jogar/Reservar) para desfazer.\n");
+        }
+        break;
+    }
+    case ACAO_INVERTER:
+    { // Inverter Fila com Pilha
+        inverterFilaComPilha(jogo);
+        escreverSaida(saida, "\n🔁 Inversão Concluída: O conteúdo da Fila e da Pilha foram trocados.\n");
+        break;
+    }
+    case ACAO_VISUALIZAR:
+    { // Visualizar
+        // Fila e pilha já são exibidas no final do loop; aqui mostra também a prévia
+        // das peças seguintes, calculada sob demanda sem alterar a partida
+        escreverSaida(saida, "\n🔭 Prévia (depois da fila):");
+        for (int i = 0; i < PROFUNDIDADE_PREVIA_MENU; i++)
+        {
+            Peca futura = espiarPreviaJogo(jogo, (uint64_t)(CAPACIDADE_FILA + i));
+            escreverSaida(saida, " [ID:%llu|%s]", (unsigned long long)futura.id, futura.nome);
+        }
+        escreverSaida(saida, "\n");
+        break;
+    }
+    case ACAO_SAIR:
+    {
+        escreverSaida(saida, "\n👋 Desafio Mestre Concluído! Encerrando o programa.\n");
+        break;
+    }
+    default:
+    {
+        escreverSaida(saida, "\n❌ Opção inválida. Tente novamente.\n");
+        break;
+    }
+    }
+
+    // Exibe ambos após qualquer ação (exceto sair)
+    if (opcao != 0)
+    {
+        escreverFila(saida, &jogo->fila);
+        escreverPilha(saida, &jogo->pilha);
+    }
+}
@@ -0,0 +1,498 @@
+/*
+ * Motor do Tetris Stack (nível Mestre): peças, fila circular, pilha, gerador baseado em
+ * contador, partida, histórico compacto, arquivos de sequência e o texto do menu.
+ *
+ * O motor não tem main nem estado global: o jogo (desafio-mestre.c), os modos de ferramenta
+ * e a biblioteca do ambiente de aprendizado (libtetris-ambiente.so) são ligados a motor.c.
+ * As funções curtas do gerador ficam aqui como static inline, para serem embutidas em
+ * quem chama.
+ */
+#ifndef MOTOR_H
+#define MOTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// --- 1. Definições e Estruturas de Dados ---
+
+#define CAPACIDADE_FILA 5
+#define CAPACIDADE_PILHA 3
+
+/**
+ * @struct Peca
+ */
+typedef struct
+{
+    uint64_t id; // Posição da peça na sequência + 1: sequências de torneio passam de 2^31 peças
+    char nome[2];
+} Peca;
+
+/**
+ * @struct FilaCircular (Next Queue)
+ * Os índices vêm antes dos itens: são lidos em toda operação e ficam no início da linha de cache.
+ */
+typedef struct
+{
+    int frente;
+    int traseira;
+    int tamanho;
+    Peca itens[CAPACIDADE_FILA];
+} FilaCircular;
+
+/**
+ * @struct Pilha (Hold Stack)
+ */
+typedef struct
+{
+    int topo;
+    Peca itens[CAPACIDADE_PILHA];
+} Pilha;
+
+// --- Estrutura de HISTÓRICO (para a função Desfazer) ---
+
+// Tipo de operação que ocorreu
+typedef enum
+{
+    OP_NENHUMA,
+    OP_JOGAR,
+    OP_RESERVAR
+    // Para simplificar, Desfazer focará apenas nas operações que alteram ambas
+} TipoOperacao;
+
+// --- 2. Variável e Função de Geração de Peças ---
+
+#define NUM_TIPOS_PECA 7
+
+static const char TIPOS_PECA[NUM_TIPOS_PECA] = {'I', 'O', 'T', 'L', 'J', 'S', 'Z'};
+
+// --- Sequências de Peças em Arquivo (torneios) ---
+
+#define SEQUENCIA_MAGICO 0x51455354u // "TSEQ"
+#define SEQUENCIA_VERSAO 1u
+#define SEQUENCIA_PECAS_POR_PALAVRA 21    // 3 bits por peça: 21 peças em cada palavra de 64 bits
+#define SEQUENCIA_JANELA_PRECARGA (8u << 20) // Bytes pedidos ao kernel à frente da leitura
+
+/**
+ * @struct CabecalhoSequencia
+ * Início de um arquivo de sequência (64 bytes, little-endian). Os tipos vêm logo depois:
+ * com 8 bits, um byte por peça; com 3 bits, 21 peças por palavra de 64 bits, a peça k nos
+ * bits 3 * (k % 21) da palavra k / 21.
+ */
+typedef struct
+{
+    uint32_t magico;
+    uint32_t versao;
+    uint32_t bits_por_peca; // 3 ou 8
+    uint32_t reservado;
+    uint64_t total_pecas;
+    uint64_t semente; // Origem da sequência: depois do fim do arquivo, o gerador puro continua dela
+    uint64_t jogo;
+    uint8_t preenchimento[24];
+} CabecalhoSequencia;
+
+/**
+ * @struct SequenciaArquivo
+ * Arquivo de sequência mapeado só para leitura. Processos que mapeiam o mesmo arquivo
+ * compartilham as mesmas páginas da cache do kernel.
+ */
+typedef struct
+{
+    const uint8_t *mapa;
+    size_t tamanho_mapa;
+    const uint8_t *bytes;     // Tipos com 8 bits por peça
+    const uint64_t *palavras; // Tipos com 3 bits por peça
+    uint64_t total_pecas;
+    uint64_t chave_continuacao;
+} SequenciaArquivo;
+
+// Posição, a partir do início dos dados, do byte que guarda a peça k
+static inline uint64_t deslocamentoNaSequencia(const SequenciaArquivo *sequencia, uint64_t k)
+{
+    return sequencia->palavras != NULL ? k / SEQUENCIA_PECAS_POR_PALAVRA * sizeof(uint64_t) : k;
+}
+
+/**
+ * @struct GeradorPecas
+ * Gerador baseado em contador: a peça k do jogo g é uma função pura de (semente, g, k).
+ * Não há estado global escondido, então qualquer ponto da sequência pode ser acessado
+ * diretamente e jogos diferentes podem ser divididos entre threads ou máquinas.
+ */
+typedef struct
+{
+    uint64_t semente;
+    uint64_t jogo;
+    uint64_t chave;   // Mistura de (semente, jogo), calculada uma vez na inicialização
+    uint64_t posicao; // Índice k da próxima peça a ser gerada (o id da peça é k + 1)
+    const SequenciaArquivo *arquivo; // Se não for NULL, as peças vêm do arquivo em vez da chave
+} GeradorPecas;
+
+/**
+ * Embaralha os bits de um contador (finalizador do SplitMix64).
+ */
+static inline uint64_t misturarBits(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static inline uint64_t chaveDoJogo(uint64_t semente, uint64_t jogo)
+{
+    return misturarBits(semente ^ misturarBits(jogo + 0x9E3779B97F4A7C15ULL));
+}
+
+/**
+ * Índice (em TIPOS_PECA) do tipo da peça na posição k, dada a chave do jogo.
+ * Usa multiplicação em vez de módulo para evitar o viés de rand() % 7.
+ */
+static inline int tipoPorChave(uint64_t chave, uint64_t k)
+{
+    uint64_t aleatorio = misturarBits(chave + k * 0x9E3779B97F4A7C15ULL);
+    return (int)(((aleatorio >> 32) * NUM_TIPOS_PECA) >> 32);
+}
+
+/**
+ * Tipo da peça k do jogo g. Função pura: o mesmo (semente, jogo, k) sempre dá o mesmo tipo.
+ */
+int tipoPecaNaPosicao(uint64_t semente, uint64_t jogo, uint64_t k);
+
+void inicializarGerador(GeradorPecas *gerador, uint64_t semente, uint64_t jogo);
+
+/**
+ * Tipo da peça k lida do arquivo; depois do fim do arquivo, a sequência continua com o
+ * gerador puro da semente e do jogo do cabeçalho. Bytes inválidos viram o primeiro tipo.
+ */
+static inline int tipoNaSequencia(const SequenciaArquivo *sequencia, uint64_t k)
+{
+    if (k >= sequencia->total_pecas)
+    {
+        return tipoPorChave(sequencia->chave_continuacao, k);
+    }
+    unsigned tipo = sequencia->palavras != NULL
+                        ? (unsigned)(sequencia->palavras[k / SEQUENCIA_PECAS_POR_PALAVRA] >> (3 * (k % SEQUENCIA_PECAS_POR_PALAVRA))) & 7u
+                        : sequencia->bytes[k];
+    return tipo < NUM_TIPOS_PECA ? (int)tipo : 0;
+}
+
+static inline int tipoDoGerador(const GeradorPecas *gerador, uint64_t k)
+{
+    return gerador->arquivo != NULL ? tipoNaSequencia(gerador->arquivo, k) : tipoPorChave(gerador->chave, k);
+}
+
+/**
+ * Posiciona o gerador na peça k (acesso aleatório à sequência).
+ */
+void posicionarGerador(GeradorPecas *gerador, uint64_t posicao);
+
+/**
+ * Gera n peças de uma vez no array destino, a partir da posição atual do gerador.
+ * O laço não chama nenhuma função (nem rand() nem strcpy), então o compilador pode vetorizá-lo.
+ */
+void gerarPecasLote(GeradorPecas *gerador, Peca *destino, int n);
+
+// Uma peça só: o caminho puro fica curto o bastante para ser embutido em jogarPeca
+Peca gerarPeca(GeradorPecas *gerador);
+
+// Índice do tipo da peça em TIPOS_PECA (0 se a letra não for reconhecida)
+static inline int indiceTipoPeca(Peca peca)
+{
+    for (int t = 0; t < NUM_TIPOS_PECA; t++)
+    {
+        if (TIPOS_PECA[t] == peca.nome[0])
+        {
+            return t;
+        }
+    }
+    return 0;
+}
+
+// --- 3. Funções da FILA CIRCULAR ---
+
+void inicializarFila(FilaCircular *fila);
+
+int filaCheia(const FilaCircular *fila);
+
+int filaVazia(const FilaCircular *fila);
+
+int enfileirar(FilaCircular *fila, Peca peca);
+
+/**
+ * Remove a peça da frente da fila e a copia para *destino.
+ * Retorna 1 em caso de sucesso ou 0 se a fila estiver vazia (destino não é alterado).
+ */
+int desenfileirar(FilaCircular *fila, Peca *destino);
+
+/**
+ * Enfileira até n peças de uma só vez, na ordem do array.
+ * A cópia é feita em no máximo dois blocos contíguos (antes e depois do fim do array circular).
+ * Retorna quantas peças foram realmente inseridas (limitado ao espaço livre).
+ */
+int enfileirarLote(FilaCircular *fila, const Peca *pecas, int n);
+
+/**
+ * Desenfileira até n peças de uma só vez para o array destino (a frente vai para destino[0]).
+ * A cópia é feita em no máximo dois blocos contíguos.
+ * Retorna quantas peças foram realmente removidas.
+ */
+int desenfileirarLote(FilaCircular *fila, Peca *destino, int n);
+
+// Obtém a peça da frente sem remover (ponteiro para a posição na fila, ou NULL se vazia)
+const Peca *espiarFila(const FilaCircular *fila);
+
+// Obtém o índice anterior à frente (para desfazer)
+int obterIndiceAnteriorFrente(const FilaCircular *fila);
+
+// Obtém o índice anterior à traseira (última peça inserida)
+int obterIndiceAnteriorTraseira(const FilaCircular *fila);
+
+// --- 4. Funções da PILHA LINEAR ---
+
+void inicializarPilha(Pilha *pilha);
+
+int pilhaCheia(const Pilha *pilha);
+
+int pilhaVazia(const Pilha *pilha);
+
+int empilhar(Pilha *pilha, Peca peca);
+
+/**
+ * Remove a peça do topo da pilha e a copia para *destino.
+ * Retorna 1 em caso de sucesso ou 0 se a pilha estiver vazia (destino não é alterado).
+ */
+int desempilhar(Pilha *pilha, Peca *destino);
+
+/**
+ * Empilha até n peças de uma só vez. Os arrays de lote da pilha usam a ordem de saída:
+ * pecas[0] fica no topo, pecas[n - 1] fica mais perto da base.
+ * Retorna quantas peças foram realmente empilhadas (limitado ao espaço livre).
+ */
+int empilharLote(Pilha *pilha, const Peca *pecas, int n);
+
+/**
+ * Desempilha até n peças de uma só vez, na ordem de saída (o topo vai para destino[0]).
+ * Retorna quantas peças foram realmente removidas.
+ */
+int desempilharLote(Pilha *pilha, Peca *destino, int n);
+
+// Obtém a peça do topo sem remover (ponteiro para a posição na pilha, ou NULL se vazia)
+const Peca *espiarPilha(const Pilha *pilha);
+
+// --- 5. Funções de Visualização e Inicialização ---
+
+/**
+ * @struct Saida
+ * Destino do texto do jogo: um arquivo (o terminal) ou um buffer de tamanho fixo, usado
+ * pelas sessões do servidor, que enviam o texto pelo socket sem bloquear.
+ */
+typedef struct
+{
+    FILE *arquivo;  // Se não for NULL, o texto vai direto para o arquivo
+    char *buffer;
+    size_t tamanho;
+    size_t capacidade;
+} Saida;
+
+void escreverSaida(Saida *saida, const char *formato, ...);
+
+void escreverFila(Saida *saida, const FilaCircular *fila);
+
+void escreverPilha(Saida *saida, const Pilha *pilha);
+
+void visualizarFila(const FilaCircular *fila);
+
+void visualizarPilha(const Pilha *pilha);
+
+void inicializarFilaAutomatica(FilaCircular *fila, GeradorPecas *gerador);
+
+// --- Janela de Prévia Preguiçosa ---
+
+/**
+ * @struct JanelaPrevia
+ * Fila de peças futuras de profundidade qualquer que não guarda as peças: como o gerador
+ * é uma função pura da posição, a peça i da janela só é calculada quando alguém a espia ou
+ * a retira. Só as peças devolvidas à frente (fora da ordem do gerador) ficam em memória.
+ */
+typedef struct
+{
+    FilaCircular devolvidas; // Peças recolocadas na frente, antes das futuras
+    GeradorPecas gerador;    // Posição da primeira peça futura ainda não retirada
+    uint64_t profundidade;   // Quantas peças a janela mostra
+} JanelaPrevia;
+
+void inicializarJanelaPrevia(JanelaPrevia *janela, uint64_t semente, uint64_t jogo, uint64_t profundidade);
+
+// Materializa a peça i da janela (0 = frente); retorna 0 se i estiver além da profundidade
+int espiarJanelaPrevia(const JanelaPrevia *janela, uint64_t i, Peca *destino);
+
+// Retira a frente: a janela desliza e a nova última peça passa a existir sem custo algum
+void retirarDaJanelaPrevia(JanelaPrevia *janela, Peca *destino);
+
+// Recoloca uma peça na frente (ex.: desfazer); retorna 0 se já houver CAPACIDADE_FILA devolvidas
+int devolverAJanelaPrevia(JanelaPrevia *janela, Peca peca);
+
+// --- 6. Motor do Jogo e Funções Estratégicas do Nível Mestre ---
+
+// Resultado de uma operação do motor (a mensagem para o jogador é escolhida por quem chamou)
+typedef enum
+{
+    RESULTADO_OK,
+    RESULTADO_FILA_VAZIA,
+    RESULTADO_PILHA_CHEIA,
+    RESULTADO_PILHA_VAZIA,
+    RESULTADO_SEM_HISTORICO
+} ResultadoOperacao;
+
+// Ações do menu, com os mesmos números das opções exibidas ao jogador
+typedef enum
+{
+    ACAO_SAIR = 0,
+    ACAO_JOGAR = 1,
+    ACAO_RESERVAR = 2,
+    ACAO_USAR = 3,
+    ACAO_TROCAR = 4,
+    ACAO_DESFAZER = 5,
+    ACAO_INVERTER = 6,
+    ACAO_VISUALIZAR = 7
+} Acao;
+
+/**
+ * @struct Jogo
+ * Estado completo de uma partida: fila, pilha, gerador e histórico da última operação.
+ * As funções do motor não imprimem nada, não alocam memória e não usam rotinas de string;
+ * depois de inicializarJogo todo o estado vive dentro desta struct.
+ * A fila vem primeiro, então frente, traseira e tamanho abrem a primeira linha de cache da
+ * partida, e o topo da pilha vem logo depois das peças da fila.
+ */
+typedef struct
+{
+    FilaCircular fila;
+    Pilha pilha;
+    GeradorPecas gerador;
+
+    // Histórico da última operação JOGAR ou RESERVAR (para a função Desfazer)
+    TipoOperacao ultima_operacao;
+    Peca peca_historico_jogada; // Peça que foi jogada/reservada
+    Peca peca_historico_nova;   // Peça nova que foi gerada e inserida
+} Jogo;
+
+/**
+ * Começa uma partida com um gerador já preparado (por exemplo, lendo de um arquivo de sequência).
+ */
+void inicializarJogoComGerador(Jogo *jogo, const GeradorPecas *gerador);
+
+void inicializarJogo(Jogo *jogo, uint64_t semente, uint64_t numero_jogo);
+
+/**
+ * Peça i da prévia de uma partida em andamento: as CAPACIDADE_FILA primeiras vêm da fila
+ * e as seguintes são calculadas sob demanda a partir do gerador, sem alterar a partida.
+ */
+Peca espiarPreviaJogo(const Jogo *jogo, uint64_t i);
+
+/**
+ * Joga a peça da frente da fila e insere uma nova peça na traseira.
+ */
+ResultadoOperacao jogarPeca(Jogo *jogo);
+
+/**
+ * Move a peça da frente da fila para o topo da pilha e insere uma nova peça na fila.
+ */
+ResultadoOperacao reservarPeca(Jogo *jogo);
+
+/**
+ * Remove a peça do topo da pilha (POP). Não gera peça nova nem salva histórico.
+ */
+ResultadoOperacao usarPecaReservada(Jogo *jogo, Peca *peca_usada);
+
+/**
+ * Troca a peça do topo da pilha com a peça da frente da fila, diretamente nos arrays.
+ */
+ResultadoOperacao trocarPilhaFila(Jogo *jogo);
+
+/**
+ * Tenta reverter a última operação de JOGAR ou RESERVAR.
+ * Nota: Implementação simplificada que desfaz o último Enqueue e reverte o Dequeue/PUSH.
+ */
+ResultadoOperacao desfazerUltimaJogada(Jogo *jogo);
+
+/**
+ * Inverte o conteúdo da Fila com o conteúdo da Pilha.
+ * (A Fila vira Pilha e a Pilha vira Fila)
+ *
+ * As peças da frente da fila vão para a pilha (a próxima peça fica no topo) e as peças
+ * da pilha vão para a frente da fila (o topo vira a próxima peça). Como a pilha comporta
+ * menos peças que a fila, as peças da fila que não cabem na pilha continuam na fila,
+ * logo atrás das peças que vieram da pilha. Nenhuma peça é perdida, e as posições que
+ * sobrarem na fila são preenchidas com peças novas para mantê-la sempre cheia.
+ */
+ResultadoOperacao inverterFilaComPilha(Jogo *jogo);
+
+/**
+ * Executa uma ação do menu sem nenhuma saída na tela (usado pelos modos de ferramenta).
+ */
+ResultadoOperacao executarAcao(Jogo *jogo, Acao acao);
+
+// --- Histórico Compacto (desfazer em vários níveis) ---
+
+#define CAMPO_ESTENDIDO 15
+
+/**
+ * @struct HistoricoCompacto
+ */
+typedef struct
+{
+    uint8_t *bytes;
+    size_t tamanho;
+    size_t capacidade;
+    uint64_t operacoes; // Registros ainda no histórico
+} HistoricoCompacto;
+
+int criarHistorico(HistoricoCompacto *historico, size_t capacidade);
+
+void liberarHistorico(HistoricoCompacto *historico);
+
+/**
+ * Executa uma ação e registra no histórico compacto o necessário para desfazê-la.
+ * Com histórico, ACAO_DESFAZER volta quantas operações o jogador quiser, e não só a última
+ * jogada ou reserva.
+ */
+ResultadoOperacao executarAcaoComHistorico(Jogo *jogo, HistoricoCompacto *historico, Acao acao);
+
+/**
+ * Desfaz a operação mais recente do histórico compacto. Como o histórico é desfeito
+ * estritamente na ordem inversa, o estado atual é sempre exatamente o de logo depois da
+ * operação e cada reversão é exata.
+ */
+ResultadoOperacao desfazerPeloHistorico(Jogo *jogo, HistoricoCompacto *historico);
+
+// --- Arquivos de Sequência Mapeados ---
+
+/**
+ * Mapeia um arquivo de sequência só para leitura e confere o cabeçalho e o tamanho.
+ * Retorna 1 em caso de sucesso.
+ */
+int abrirSequenciaArquivo(SequenciaArquivo *sequencia, const char *caminho);
+
+void fecharSequenciaArquivo(SequenciaArquivo *sequencia);
+
+// Gerador da partida posicionado no início da sequência do arquivo
+void inicializarGeradorComArquivo(GeradorPecas *gerador, const SequenciaArquivo *sequencia);
+
+// --- Menu Estratégico (texto compartilhado pelo terminal e pelas sessões do servidor) ---
+
+#define PROFUNDIDADE_PREVIA_MENU 10
+
+void exibirMenu(Saida *saida);
+
+void exibirBoasVindas(Saida *saida, const Jogo *jogo);
+
+/**
+ * Executa uma opção do menu e escreve a resposta (mensagem + fila e pilha) na saída.
+ * Não lê nada: quem chama decide de onde vem a opção (scanf no terminal, socket no servidor).
+ */
+void processarOpcaoMenu(Jogo *jogo, int opcao, Saida *saida);
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Protocolo de texto das sessões do servidor (desafio-mestre --servidor CAMINHO).
+ *
+ * O cliente envia uma opção do menu por linha ("1\n" ... "7\n", "0\n" para sair). O servidor
+ * responde exatamente o que o menu do terminal imprimiria, e cada resposta termina com o
+ * PROMPT_MENU; é por ele que o cliente sabe que a resposta chegou inteira.
+ */
+#ifndef PROTOCOLO_SESSOES_H
+#define PROTOCOLO_SESSOES_H
+
+#define CAMINHO_SOCKET_PADRAO "/tmp/tetris-stack.sock"
+#define PROMPT_MENU "\nEscolha uma opção: "
+
+#endif
@@ -0,0 +1,435 @@
+// Servidor de sessões do nível Mestre (desafio-mestre --servidor CAMINHO)
+// Extensões GNU: accept4
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#endif
+
+#include "motor.h"
+#include "ferramentas.h"
+#include "protocolo-sessoes.h"
+
+// --- Servidor de Sessões (epoll, uma máquina de estados por cliente) ---
+
+/*
+ * Cada laço de eventos roda numa thread fixada em um núcleo e atende milhares de clientes
+ * sem bloquear: em vez de uma pilha de chamadas esperando no scanf, cada cliente é uma
+ * SessaoCliente com dois estados, LENDO (espera uma linha) e ESCREVENDO (a resposta não
+ * coube de uma vez no socket). Todos os laços compartilham o socket de escuta (EPOLLEXCLUSIVE
+ * acorda só um deles por conexão nova).
+ */
+
+#ifdef __linux__
+#define TAMANHO_ENTRADA_SESSAO 64
+#define TAMANHO_SAIDA_SESSAO 2048
+#define EVENTOS_POR_ESPERA 256
+
+typedef enum
+{
+    SESSAO_LENDO,
+    SESSAO_ESCREVENDO
+} EstadoSessao;
+
+/**
+ * @struct SessaoCliente
+ */
+typedef struct
+{
+    int descritor;
+    EstadoSessao estado;
+    int encerrando; // Opção 0 recebida: fecha depois de enviar a despedida
+    size_t tamanho_entrada;
+    size_t enviado; // Bytes da saída já enviados
+    Saida saida;
+    Jogo jogo;
+    char entrada[TAMANHO_ENTRADA_SESSAO];
+    char buffer_saida[TAMANHO_SAIDA_SESSAO];
+} SessaoCliente;
+
+/**
+ * @struct LacoEventos
+ */
+typedef struct
+{
+    _Alignas(TAMANHO_LINHA_CACHE) uint64_t clientes_atendidos;
+    uint64_t requisicoes;
+    int falhou; // 1 = o laço não conseguiu criar seu epoll
+    pthread_t thread;
+    int cpu;
+    int escuta;
+    uint64_t semente;
+    uint64_t *proximo_jogo;      // Cada cliente joga uma partida diferente da mesma semente
+    uint64_t *conectados;        // Clientes abertos agora, somando todos os laços
+    uint64_t *maior_conectados;  // Pico de conectados ao mesmo tempo no processo
+} LacoEventos;
+
+static volatile sig_atomic_t servidor_parar = 0;
+
+static void pararServidor(int sinal)
+{
+    (void)sinal;
+    servidor_parar = 1;
+}
+
+// Envia o que couber da saída; retorna 0 se a conexão falhou
+static int enviarSaidaSessao(SessaoCliente *sessao)
+{
+    while (sessao->enviado < sessao->saida.tamanho)
+    {
+        ssize_t n = send(sessao->descritor, sessao->buffer_saida + sessao->enviado,
+                         sessao->saida.tamanho - sessao->enviado, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        sessao->enviado += (size_t)n;
+    }
+    sessao->saida.tamanho = 0;
+    sessao->enviado = 0;
+    return 1;
+}
+
+// Interpreta as linhas completas da entrada como o scanf("%d") do menu do terminal
+static void processarEntradaSessao(SessaoCliente *sessao, uint64_t *requisicoes)
+{
+    // Só processa enquanto houver espaço para a maior resposta possível
+    while (!sessao->encerrando && sessao->saida.tamanho < TAMANHO_SAIDA_SESSAO / 2)
+    {
+        char *fim_linha = memchr(sessao->entrada, '\n', sessao->tamanho_entrada);
+        if (fim_linha == NULL)
+        {
+            if (sessao->tamanho_entrada == TAMANHO_ENTRADA_SESSAO)
+            {
+                sessao->tamanho_entrada = 0; // Linha longa demais: descartada
+                escreverSaida(&sessao->saida, "🚫 Entrada inválida. Por favor, digite um número.\n");
+                exibirMenu(&sessao->saida);
+            }
+            return;
+        }
+
+        *fim_linha = '\0';
+        char *resto;
+        long opcao = strtol(sessao->entrada, &resto, 10);
+        size_t consumidos = (size_t)(fim_linha - sessao->entrada) + 1;
+
+        if (resto == sessao->entrada)
+        {
+            escreverSaida(&sessao->saida, "🚫 Entrada inválida. Por favor, digite um número.\n");
+            exibirMenu(&sessao->saida);
+        }
+        else
+        {
+            processarOpcaoMenu(&sessao->jogo, (int)opcao, &sessao->saida);
+            if (opcao == ACAO_SAIR)
+            {
+                sessao->encerrando = 1;
+            }
+            else
+            {
+                exibirMenu(&sessao->saida);
+            }
+            (*requisicoes)++;
+        }
+
+        sessao->tamanho_entrada -= consumidos;
+        memmove(sessao->entrada, fim_linha + 1, sessao->tamanho_entrada);
+    }
+}
+
+static void fecharSessao(LacoEventos *laco, int epoll, SessaoCliente *sessao)
+{
+    epoll_ctl(epoll, EPOLL_CTL_DEL, sessao->descritor, NULL);
+    close(sessao->descritor);
+    free(sessao);
+    __atomic_fetch_sub(laco->conectados, 1, __ATOMIC_RELAXED);
+}
+
+// Troca o interesse no epoll conforme o estado da sessão
+static void mudarEstadoSessao(int epoll, SessaoCliente *sessao, EstadoSessao estado)
+{
+    if (sessao->estado == estado)
+    {
+        return;
+    }
+    struct epoll_event evento;
+    evento.events = estado == SESSAO_LENDO ? EPOLLIN : EPOLLOUT;
+    evento.data.ptr = sessao;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, sessao->descritor, &evento);
+    sessao->estado = estado;
+}
+
+// Depois de ler ou de conseguir escrever: responde o que der e decide o próximo estado
+static void avancarSessao(LacoEventos *laco, int epoll, SessaoCliente *sessao)
+{
+    for (;;)
+    {
+        processarEntradaSessao(sessao, &laco->requisicoes);
+        if (!enviarSaidaSessao(sessao))
+        {
+            fecharSessao(laco, epoll, sessao);
+            return;
+        }
+        if (sessao->saida.tamanho > 0)
+        {
+            mudarEstadoSessao(epoll, sessao, SESSAO_ESCREVENDO);
+            return;
+        }
+        if (sessao->encerrando)
+        {
+            fecharSessao(laco, epoll, sessao);
+            return;
+        }
+        // Tudo enviado: se ainda houver uma linha completa na entrada, responde-a também
+        if (memchr(sessao->entrada, '\n', sessao->tamanho_entrada) == NULL)
+        {
+            mudarEstadoSessao(epoll, sessao, SESSAO_LENDO);
+            return;
+        }
+    }
+}
+
+static void aceitarClientes(LacoEventos *laco, int epoll)
+{
+    for (;;)
+    {
+        int descritor = accept4(laco->escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descritor < 0)
+        {
+            return; // EAGAIN: outro laço pegou a conexão ou não há mais nenhuma
+        }
+
+        SessaoCliente *sessao = malloc(sizeof(SessaoCliente));
+        if (sessao == NULL)
+        {
+            close(descritor);
+            continue;
+        }
+        sessao->descritor = descritor;
+        sessao->estado = SESSAO_LENDO;
+        sessao->encerrando = 0;
+        sessao->tamanho_entrada = 0;
+        sessao->enviado = 0;
+        sessao->saida = (Saida){NULL, sessao->buffer_saida, 0, TAMANHO_SAIDA_SESSAO};
+        inicializarJogo(&sessao->jogo, laco->semente, __atomic_fetch_add(laco->proximo_jogo, 1, __ATOMIC_RELAXED));
+
+        struct epoll_event evento;
+        evento.events = EPOLLIN;
+        evento.data.ptr = sessao;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, descritor, &evento) != 0)
+        {
+            close(descritor);
+            free(sessao);
+            continue;
+        }
+
+        // O pico é do processo inteiro: os laços dividem os clientes, então os picos de cada
+        // laço, somados, contariam momentos diferentes como se fossem o mesmo
+        laco->clientes_atendidos++;
+        uint64_t conectados = __atomic_add_fetch(laco->conectados, 1, __ATOMIC_RELAXED);
+        uint64_t maior = __atomic_load_n(laco->maior_conectados, __ATOMIC_RELAXED);
+        while (conectados > maior &&
+               !__atomic_compare_exchange_n(laco->maior_conectados, &maior, conectados, 1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+        {
+        }
+
+        exibirBoasVindas(&sessao->saida, &sessao->jogo);
+        exibirMenu(&sessao->saida);
+        avancarSessao(laco, epoll, sessao);
+    }
+}
+
+static void *executarLacoEventos(void *argumento)
+{
+    LacoEventos *laco = argumento;
+    fixarThreadNoNucleo(laco->cpu);
+
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event evento;
+    evento.events = EPOLLIN | EPOLLEXCLUSIVE;
+    evento.data.ptr = NULL; // NULL identifica o socket de escuta
+    if (epoll < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, laco->escuta, &evento) != 0)
+    {
+        perror("epoll");
+        if (epoll >= 0)
+        {
+            close(epoll);
+        }
+        laco->falhou = 1;
+        servidor_parar = 1; // Um laço a menos deixaria parte das conexões sem ninguém para aceitá-las
+        return NULL;
+    }
+
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
+    while (!servidor_parar)
+    {
+        // Espera curta só para notar o pedido de parada; com clientes ativos nunca expira
+        int prontos = epoll_wait(epoll, eventos, EVENTOS_POR_ESPERA, 100);
+        for (int i = 0; i < prontos; i++)
+        {
+            SessaoCliente *sessao = eventos[i].data.ptr;
+            if (sessao == NULL)
+            {
+                aceitarClientes(laco, epoll);
+                continue;
+            }
+
+            if (eventos[i].events & (EPOLLERR | EPOLLHUP) && !(eventos[i].events & EPOLLIN))
+            {
+                fecharSessao(laco, epoll, sessao);
+                continue;
+            }
+
+            if (sessao->estado == SESSAO_LENDO)
+            {
+                ssize_t n = recv(sessao->descritor, sessao->entrada + sessao->tamanho_entrada,
+                                 TAMANHO_ENTRADA_SESSAO - sessao->tamanho_entrada, 0);
+                if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+                {
+                    fecharSessao(laco, epoll, sessao); // Cliente desconectou
+                    continue;
+                }
+                if (n > 0)
+                {
+                    sessao->tamanho_entrada += (size_t)n;
+                }
+            }
+            avancarSessao(laco, epoll, sessao);
+        }
+    }
+
+    // Sessões ainda abertas são descartadas junto com o processo
+    close(epoll);
+    return NULL;
+}
+
+// Sobe o limite de descritores abertos até o máximo permitido (um por cliente)
+static void aumentarLimiteDescritores()
+{
+    struct rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max)
+    {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+}
+
+/**
+ * Serve o menu do nível Mestre em um socket Unix, com um laço de eventos por thread.
+ * Roda até receber SIGINT ou SIGTERM e então imprime quantos clientes foram atendidos.
+ */
+int executarServidor(const char *caminho, uint64_t semente, int num_threads)
+{
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS)
+    {
+        num_threads = MAX_THREADS;
+    }
+
+    struct sockaddr_un endereco;
+    if (strlen(caminho) >= sizeof(endereco.sun_path))
+    {
+        printf("❌ Caminho do socket longo demais: %s\n", caminho);
+        return 1;
+    }
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho);
+
+    int escuta = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(caminho);
+    if (escuta < 0 || bind(escuta, (struct sockaddr *)&endereco, sizeof(endereco)) != 0 ||
+        listen(escuta, SOMAXCONN) != 0)
+    {
+        perror(caminho);
+        if (escuta >= 0)
+        {
+            close(escuta);
+        }
+        return 1;
+    }
+
+    aumentarLimiteDescritores();
+    signal(SIGINT, pararServidor);
+    signal(SIGTERM, pararServidor);
+    signal(SIGPIPE, SIG_IGN);
+
+    int num_cpus = contarNucleos();
+    uint64_t proximo_jogo = 0, conectados = 0, maior_conectados = 0;
+    LacoEventos *lacos = aligned_alloc(TAMANHO_LINHA_CACHE, num_threads * sizeof(LacoEventos));
+    if (lacos == NULL)
+    {
+        printf("❌ Memória insuficiente para %d laços de eventos.\n", num_threads);
+        close(escuta);
+        unlink(caminho);
+        return 1;
+    }
+    memset(lacos, 0, num_threads * sizeof(LacoEventos));
+
+    printf("🛰️  Servidor de sessões em %s | Semente: %llu | Laços de eventos: %d\n", caminho,
+           (unsigned long long)semente, num_threads);
+    fflush(stdout);
+
+    int criados = 0;
+    int falhas = 0;
+    for (; criados < num_threads; criados++)
+    {
+        lacos[criados].cpu = criados % num_cpus;
+        lacos[criados].escuta = escuta;
+        lacos[criados].semente = semente;
+        lacos[criados].proximo_jogo = &proximo_jogo;
+        lacos[criados].conectados = &conectados;
+        lacos[criados].maior_conectados = &maior_conectados;
+        int erro = pthread_create(&lacos[criados].thread, NULL, executarLacoEventos, &lacos[criados]);
+        if (erro != 0)
+        {
+            printf("❌ Não foi possível criar o laço de eventos %d de %d: %s\n", criados + 1, num_threads, strerror(erro));
+            servidor_parar = 1;
+            falhas++;
+            break;
+        }
+    }
+
+    uint64_t atendidos = 0, requisicoes = 0;
+    for (int i = 0; i < criados; i++)
+    {
+        pthread_join(lacos[i].thread, NULL);
+        atendidos += lacos[i].clientes_atendidos;
+        requisicoes += lacos[i].requisicoes;
+        falhas += lacos[i].falhou;
+    }
+    free(lacos);
+    close(escuta);
+    unlink(caminho);
+
+    printf("\n👋 Servidor encerrado: %llu clientes atendidos, %llu opções respondidas, até %llu conectados ao mesmo tempo.\n",
+           (unsigned long long)atendidos, (unsigned long long)requisicoes, (unsigned long long)maior_conectados);
+    return falhas > 0;
+}
+#else
+int executarServidor(const char *caminho, uint64_t semente, int num_threads)
+{
+    (void)caminho;
+    (void)semente;
+    (void)num_threads;
+    printf("❌ O servidor de sessões usa epoll e só está disponível no Linux.\n");
+    return 1;
+}
+#endif
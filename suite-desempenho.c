@@ -0,0 +1,450 @@
+// Suíte de desempenho do nível Mestre (desafio-mestre --desempenho ARQUIVO [--base ARQUIVO])
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "motor.h"
+#include "ferramentas.h"
+
+// --- Suíte de Desempenho com Linha de Base ---
+
+/*
+ * Cenários de ponta a ponta medidos em janelas de OPERACOES_POR_JANELA operações. Cada cenário
+ * vira uma linha estável em bench_output.txt e, com --base, é comparado com a linha de mesmo
+ * nome do arquivo de base guardado no repositório.
+ *
+ * A comparação não usa números absolutos de uma máquina: o primeiro cenário é uma calibração
+ * (uma cadeia de misturas de bits, sem memória nem desvios), e cada cenário é comparado pela
+ * vazão relativa a ela. O p99 da base é convertido para esta máquina pela razão entre as
+ * vazões da calibração. Os valores são medianas de REPETICOES_DESEMPENHO execuções.
+ *
+ * O "p99" é o p99 das médias por operação das janelas de OPERACOES_POR_JANELA operações, não
+ * a latência de operações individuais: mede janelas lentas (interrupções, faltas de cache,
+ * caminhos raros), não a cauda de cada chamada.
+ *
+ * Cada janela é medida por duas leituras do relógio, então uma diferença por operação menor
+ * que RESOLUCAO_JANELA_NS / OPERACOES_POR_JANELA não é distinguível e nunca conta como regressão.
+ */
+
+#define REPETICOES_DESEMPENHO 7
+#define RESOLUCAO_JANELA_NS 50.0 // Custo e oscilação de um par de clock_gettime por janela
+#define PISO_RUIDO_NS (RESOLUCAO_JANELA_NS / OPERACOES_POR_JANELA)
+#define REGRESSAO_VAZAO 1
+#define REGRESSAO_P99 2
+#define CONFIRMACOES_REGRESSAO 2 // Remedições antes de um cenário ser dado como regressão
+#define PROFUNDIDADE_FILA_PROFUNDA 1024
+#define REPOSICAO_FILA_PROFUNDA 256
+#define MAX_CENARIOS_BASE 32
+
+// Partida do nível Mestre com todas as ações do menu, em ordem fixa
+static const Acao ROTEIRO_MESTRE[] = {
+    ACAO_JOGAR,   ACAO_RESERVAR, ACAO_JOGAR,    ACAO_RESERVAR, ACAO_TROCAR, ACAO_USAR,     ACAO_JOGAR,
+    ACAO_DESFAZER, ACAO_INVERTER, ACAO_RESERVAR, ACAO_TROCAR,   ACAO_JOGAR,  ACAO_DESFAZER, ACAO_INVERTER,
+    ACAO_USAR,    ACAO_USAR,     ACAO_JOGAR,    ACAO_RESERVAR, ACAO_JOGAR,  ACAO_TROCAR,
+};
+#define TAMANHO_ROTEIRO_MESTRE ((int)(sizeof(ROTEIRO_MESTRE) / sizeof(ROTEIRO_MESTRE[0])))
+
+/**
+ * @struct CenarioDesempenho
+ * Cada cenário preenche tempos[j] com a duração da janela j e retorna uma soma de controle,
+ * que impede o compilador de descartar o trabalho e precisa ser igual entre repetições.
+ */
+typedef struct
+{
+    const char *nome;
+    uint64_t janelas;
+    uint64_t (*executar)(uint64_t semente, uint64_t janelas, double *tempos);
+} CenarioDesempenho;
+
+/**
+ * @struct ResultadoDesempenho
+ */
+typedef struct
+{
+    char nome[64];
+    double vazao;    // Operações por segundo na janela mediana (mediana entre as repetições)
+    double relativa; // Vazão dividida pela vazão da calibração na mesma execução
+    double p99_ns;   // p99 das médias por operação das janelas (mediana entre as repetições)
+} ResultadoDesempenho;
+
+// Cada operação é um passo de uma cadeia dependente de misturarBits: só aritmética de inteiros
+static uint64_t cenarioCalibracao(uint64_t semente, uint64_t janelas, double *tempos)
+{
+    uint64_t estado = semente;
+    for (uint64_t j = 0; j < janelas; j++)
+    {
+        double inicio = tempoAgora();
+        for (int i = 0; i < OPERACOES_POR_JANELA; i++)
+        {
+            estado = misturarBits(estado);
+        }
+        tempos[j] = tempoAgora() - inicio;
+    }
+    return estado;
+}
+
+static uint64_t cenarioSessaoMestre(uint64_t semente, uint64_t janelas, double *tempos)
+{
+    Jogo jogo;
+    inicializarJogo(&jogo, semente, 0);
+    uint64_t soma = 0;
+    int passo = 0;
+
+    for (uint64_t j = 0; j < janelas; j++)
+    {
+        double inicio = tempoAgora();
+        for (int i = 0; i < OPERACOES_POR_JANELA; i++)
+        {
+            soma += executarAcao(&jogo, ROTEIRO_MESTRE[passo]);
+            passo = passo + 1 == TAMANHO_ROTEIRO_MESTRE ? 0 : passo + 1;
+        }
+        tempos[j] = tempoAgora() - inicio;
+        soma += jogo.fila.itens[jogo.fila.frente].id;
+    }
+    return soma;
+}
+
+// Retira uma peça por operação de um anel profundo, reposto em lotes com gerarPecasLote
+static uint64_t cenarioFilaProfunda(uint64_t semente, uint64_t janelas, double *tempos)
+{
+    static Peca anel[PROFUNDIDADE_FILA_PROFUNDA];
+    GeradorPecas gerador;
+    inicializarGerador(&gerador, semente, 0);
+    gerarPecasLote(&gerador, anel, PROFUNDIDADE_FILA_PROFUNDA);
+
+    uint64_t soma = 0;
+    int frente = 0;
+    int retiradas = 0;
+    for (uint64_t j = 0; j < janelas; j++)
+    {
+        double inicio = tempoAgora();
+        for (int i = 0; i < OPERACOES_POR_JANELA; i++)
+        {
+            soma += (uint64_t)anel[frente].nome[0];
+            frente = (frente + 1) % PROFUNDIDADE_FILA_PROFUNDA;
+            if (++retiradas == REPOSICAO_FILA_PROFUNDA)
+            {
+                // As posições recém-liberadas ficam logo atrás da frente
+                int inicio_reposicao = (frente - REPOSICAO_FILA_PROFUNDA + PROFUNDIDADE_FILA_PROFUNDA) % PROFUNDIDADE_FILA_PROFUNDA;
+                gerarPecasLote(&gerador, &anel[inicio_reposicao], REPOSICAO_FILA_PROFUNDA);
+                retiradas = 0;
+            }
+        }
+        tempos[j] = tempoAgora() - inicio;
+    }
+    return soma;
+}
+
+// Geração em lote de muitas partidas curtas: cada operação é uma peça
+static uint64_t cenarioGeracaoLote(uint64_t semente, uint64_t janelas, double *tempos)
+{
+    Peca bloco[OPERACOES_POR_JANELA];
+    uint64_t soma = 0;
+
+    for (uint64_t j = 0; j < janelas; j++)
+    {
+        GeradorPecas gerador;
+        double inicio = tempoAgora();
+        inicializarGerador(&gerador, semente, j);
+        gerarPecasLote(&gerador, bloco, OPERACOES_POR_JANELA);
+        tempos[j] = tempoAgora() - inicio;
+        soma += (uint64_t)bloco[j % OPERACOES_POR_JANELA].nome[0] + (uint64_t)bloco[OPERACOES_POR_JANELA - 1].nome[0];
+    }
+    return soma;
+}
+
+// Ações com histórico compacto seguidas de desfazer tudo, em blocos de uma janela
+static uint64_t cenarioHistoricoDesfazer(uint64_t semente, uint64_t janelas, double *tempos)
+{
+    Jogo jogo;
+    HistoricoCompacto historico;
+    if (!criarHistorico(&historico, 4 * OPERACOES_POR_JANELA))
+    {
+        return 0;
+    }
+    inicializarJogo(&jogo, semente, 0);
+
+    uint64_t soma = 0;
+    for (uint64_t j = 0; j < janelas; j++)
+    {
+        double inicio = tempoAgora();
+        for (int i = 0; i < OPERACOES_POR_JANELA / 2; i++)
+        {
+            soma += executarAcaoComHistorico(&jogo, &historico, ROTEIRO_MESTRE[i % TAMANHO_ROTEIRO_MESTRE]);
+        }
+        for (int i = 0; i < OPERACOES_POR_JANELA / 2; i++)
+        {
+            soma += desfazerPeloHistorico(&jogo, &historico);
+        }
+        tempos[j] = tempoAgora() - inicio;
+    }
+    liberarHistorico(&historico);
+    return soma + (uint64_t)jogo.gerador.posicao;
+}
+
+// A calibração vem primeiro: os outros cenários são comparados relativos a ela
+static const CenarioDesempenho CENARIOS_DESEMPENHO[] = {
+    {"calibracao", 32768, cenarioCalibracao},
+    {"sessao_mestre", 32768, cenarioSessaoMestre},
+    {"fila_profunda", 131072, cenarioFilaProfunda},
+    {"geracao_lote", 131072, cenarioGeracaoLote},
+    {"historico_desfazer", 32768, cenarioHistoricoDesfazer},
+};
+#define NUM_CENARIOS_DESEMPENHO ((int)(sizeof(CENARIOS_DESEMPENHO) / sizeof(CENARIOS_DESEMPENHO[0])))
+
+/**
+ * Mediana de REPETICOES_DESEMPENHO execuções, tanto da vazão quanto do p99: uma execução
+ * isolada com interrupções do sistema (ou excepcionalmente rápida) não move o resultado.
+ */
+static int medirCenario(const CenarioDesempenho *cenario, uint64_t semente, double *tempos, ResultadoDesempenho *resultado)
+{
+    double vazoes[REPETICOES_DESEMPENHO];
+    double p99s[REPETICOES_DESEMPENHO];
+    uint64_t soma_referencia = 0;
+    snprintf(resultado->nome, sizeof(resultado->nome), "%s", cenario->nome);
+
+    for (int r = 0; r < REPETICOES_DESEMPENHO; r++)
+    {
+        uint64_t soma = cenario->executar(semente, cenario->janelas, tempos);
+        if (r == 0)
+        {
+            soma_referencia = soma;
+        }
+        else if (soma != soma_referencia)
+        {
+            printf("❌ %s: a soma de controle mudou entre repetições.\n", cenario->nome);
+            return 0;
+        }
+
+        // A vazão vem da janela mediana: uma interrupção isolada não a desloca
+        qsort(tempos, cenario->janelas, sizeof(double), compararDouble);
+        vazoes[r] = OPERACOES_POR_JANELA / tempos[cenario->janelas / 2];
+        p99s[r] = tempos[(cenario->janelas * 99) / 100] * 1e9 / OPERACOES_POR_JANELA;
+    }
+
+    qsort(vazoes, REPETICOES_DESEMPENHO, sizeof(double), compararDouble);
+    qsort(p99s, REPETICOES_DESEMPENHO, sizeof(double), compararDouble);
+    resultado->vazao = vazoes[REPETICOES_DESEMPENHO / 2];
+    resultado->p99_ns = p99s[REPETICOES_DESEMPENHO / 2];
+    resultado->relativa = 1.0;
+    return 1;
+}
+
+// Formato estável: "# comentário" ou "nome vazao_ops_s=V relativa=R p99_ns=P", uma linha por cenário
+static int escreverResultadosDesempenho(const char *caminho, uint64_t semente, const ResultadoDesempenho *resultados, int n)
+{
+    FILE *arquivo = fopen(caminho, "w");
+    if (arquivo == NULL)
+    {
+        perror(caminho);
+        return 0;
+    }
+    fprintf(arquivo, "# tetris-stack desempenho v2 | semente %llu | janelas de %d operações | mediana de %d\n",
+            (unsigned long long)semente, OPERACOES_POR_JANELA, REPETICOES_DESEMPENHO);
+    for (int i = 0; i < n; i++)
+    {
+        fprintf(arquivo, "%-20s vazao_ops_s=%.0f relativa=%.4f p99_ns=%.2f\n", resultados[i].nome, resultados[i].vazao,
+                resultados[i].relativa, resultados[i].p99_ns);
+    }
+    fclose(arquivo);
+    return 1;
+}
+
+/**
+ * Compara o cenário com a linha de base, ambos na escala desta máquina (escala = vazão da
+ * calibração da base / vazão da calibração agora). Retorna REGRESSAO_VAZAO e/ou REGRESSAO_P99
+ * quando a piora passa da tolerância e também de PISO_RUIDO_NS por operação, ou 0.
+ */
+static int compararComBase(const ResultadoDesempenho *resultado, const ResultadoDesempenho *referencia,
+                           double vazao_calibracao, double escala, double tolerancia_vazao, double tolerancia_p99,
+                           double *delta_vazao, double *p99_base)
+{
+    *delta_vazao = 100.0 * (resultado->relativa / referencia->relativa - 1.0);
+    double ns_base = 1e9 / (referencia->relativa * vazao_calibracao);
+    double ns_agora = 1e9 / resultado->vazao;
+    *p99_base = referencia->p99_ns * escala;
+
+    int regressao = 0;
+    if (*delta_vazao < -tolerancia_vazao && ns_agora - ns_base > PISO_RUIDO_NS)
+    {
+        regressao |= REGRESSAO_VAZAO;
+    }
+    if (resultado->p99_ns > *p99_base * (1.0 + tolerancia_p99 / 100.0) && resultado->p99_ns - *p99_base > PISO_RUIDO_NS)
+    {
+        regressao |= REGRESSAO_P99;
+    }
+    return regressao;
+}
+
+// Descrição da situação de um cenário na tabela
+static const char *descreverRegressao(int regressao)
+{
+    switch (regressao)
+    {
+    case REGRESSAO_VAZAO:
+        return "❌ regressão (vazão)";
+    case REGRESSAO_P99:
+        return "❌ regressão (p99)";
+    case REGRESSAO_VAZAO | REGRESSAO_P99:
+        return "❌ regressão (vazão e p99)";
+    default:
+        return "✅";
+    }
+}
+
+static int lerResultadosDesempenho(const char *caminho, ResultadoDesempenho *resultados, int capacidade)
+{
+    FILE *arquivo = fopen(caminho, "r");
+    if (arquivo == NULL)
+    {
+        perror(caminho);
+        return -1;
+    }
+
+    char linha[256];
+    int n = 0;
+    while (n < capacidade && fgets(linha, sizeof(linha), arquivo) != NULL)
+    {
+        ResultadoDesempenho *resultado = &resultados[n];
+        if (linha[0] != '#' &&
+            sscanf(linha, "%63s vazao_ops_s=%lf relativa=%lf p99_ns=%lf", resultado->nome, &resultado->vazao,
+                   &resultado->relativa, &resultado->p99_ns) == 4)
+        {
+            n++;
+        }
+    }
+    fclose(arquivo);
+    return n;
+}
+
+/**
+ * Roda todos os cenários, grava os resultados em `saida` e, se houver `arquivo_base`,
+ * compara cada cenário com a base. Retorna 1 se algum cenário regrediu além das tolerâncias.
+ */
+int executarSuiteDesempenho(uint64_t semente, const char *saida, const char *arquivo_base, double tolerancia_vazao,
+                            double tolerancia_p99)
+{
+    ResultadoDesempenho resultados[NUM_CENARIOS_DESEMPENHO];
+    ResultadoDesempenho base[MAX_CENARIOS_BASE];
+    int total_base = 0;
+
+    if (arquivo_base != NULL)
+    {
+        total_base = lerResultadosDesempenho(arquivo_base, base, MAX_CENARIOS_BASE);
+        if (total_base < 0)
+        {
+            return 1;
+        }
+    }
+
+    uint64_t maior_janelas = 0;
+    for (int c = 0; c < NUM_CENARIOS_DESEMPENHO; c++)
+    {
+        if (CENARIOS_DESEMPENHO[c].janelas > maior_janelas)
+        {
+            maior_janelas = CENARIOS_DESEMPENHO[c].janelas;
+        }
+    }
+    double *tempos = malloc(maior_janelas * sizeof(double));
+    if (tempos == NULL)
+    {
+        return 1;
+    }
+
+    printf("📏 Suíte de Desempenho\n");
+    printf("Semente: %llu | Resultados: %s | Base: %s | Tolerância: vazão %.0f%%, p99 %.0f%% (piso %.3f ns por operação)\n",
+           (unsigned long long)semente, saida, arquivo_base != NULL ? arquivo_base : "(nenhuma)", tolerancia_vazao,
+           tolerancia_p99, PISO_RUIDO_NS);
+    printf("p99 ns = p99 das médias por operação em janelas de %d operações (base convertida para esta máquina)\n",
+           OPERACOES_POR_JANELA);
+    printf("---------------------------------------------------\n");
+    printf("%-*s | %14s | %9s | %9s | %*s | %9s | %9s | Situação\n", 20 + bytesExtrasUtf8("Cenário"), "Cenário",
+           "ops/s", "relativa", "base", 7 + bytesExtrasUtf8("Δ"), "Δ", "p99 ns", "base");
+
+    int regressoes = 0;
+    double vazao_calibracao = 0.0;
+    double vazao_calibracao_base = 0.0; // 0 se a base não tiver a calibração: o p99 fica sem conversão
+    for (int b = 0; b < total_base; b++)
+    {
+        if (strcmp(base[b].nome, CENARIOS_DESEMPENHO[0].nome) == 0)
+        {
+            vazao_calibracao_base = base[b].vazao;
+        }
+    }
+    for (int c = 0; c < NUM_CENARIOS_DESEMPENHO; c++)
+    {
+        ResultadoDesempenho *resultado = &resultados[c];
+        if (!medirCenario(&CENARIOS_DESEMPENHO[c], semente, tempos, resultado))
+        {
+            free(tempos);
+            return 1;
+        }
+        if (c == 0)
+        {
+            vazao_calibracao = resultado->vazao;
+        }
+        resultado->relativa = resultado->vazao / vazao_calibracao;
+
+        const ResultadoDesempenho *referencia = NULL;
+        for (int b = 0; b < total_base; b++)
+        {
+            if (strcmp(base[b].nome, resultado->nome) == 0)
+            {
+                referencia = &base[b];
+            }
+        }
+
+        if (referencia == NULL || c == 0)
+        {
+            printf("%-20s | %14.0f | %9.4f | %9s | %7s | %9.2f | %9s | %s\n", resultado->nome, resultado->vazao,
+                   resultado->relativa, referencia != NULL ? "1.0000" : "-", "-", resultado->p99_ns, "-",
+                   referencia != NULL ? "referência" : "sem base");
+            continue;
+        }
+
+        double delta_vazao, p99_base;
+        double escala = vazao_calibracao_base > 0.0 ? vazao_calibracao_base / vazao_calibracao : 1.0;
+        int regrediu = compararComBase(resultado, referencia, vazao_calibracao, escala, tolerancia_vazao, tolerancia_p99,
+                                       &delta_vazao, &p99_base);
+
+        // Uma regressão só conta se sobreviver a novas medições: um surto de carga na máquina
+        // pode durar as REPETICOES_DESEMPENHO execuções de um cenário, mas raramente mais
+        for (int tentativa = 0; regrediu && tentativa < CONFIRMACOES_REGRESSAO; tentativa++)
+        {
+            ResultadoDesempenho calibracao, remedicao;
+            if (!medirCenario(&CENARIOS_DESEMPENHO[0], semente, tempos, &calibracao) ||
+                !medirCenario(&CENARIOS_DESEMPENHO[c], semente, tempos, &remedicao))
+            {
+                free(tempos);
+                return 1;
+            }
+            remedicao.relativa = remedicao.vazao / calibracao.vazao;
+            escala = vazao_calibracao_base > 0.0 ? vazao_calibracao_base / calibracao.vazao : 1.0;
+            regrediu = compararComBase(&remedicao, referencia, calibracao.vazao, escala, tolerancia_vazao, tolerancia_p99,
+                                       &delta_vazao, &p99_base);
+            *resultado = remedicao;
+        }
+        regressoes += regrediu != 0;
+        // Depois de remedir, a linha mostra a última medição, a mesma que decidiu a situação
+        printf("%-20s | %14.0f | %9.4f | %9.4f | %+6.1f%% | %9.2f | %9.2f | %s\n", resultado->nome, resultado->vazao,
+               resultado->relativa, referencia->relativa, delta_vazao, resultado->p99_ns, p99_base,
+               descreverRegressao(regrediu));
+    }
+    free(tempos);
+
+    if (!escreverResultadosDesempenho(saida, semente, resultados, NUM_CENARIOS_DESEMPENHO))
+    {
+        return 1;
+    }
+    printf("---------------------------------------------------\n");
+    if (regressoes > 0)
+    {
+        printf("❌ %d cenário(s) pioraram além da tolerância em relação à base.\n", regressoes);
+        return 1;
+    }
+    printf("✅ Nenhuma regressão%s.\n", arquivo_base != NULL ? " em relação à base" : " (sem base para comparar)");
+    return 0;
+}